@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+constexpr int kBestOfRuns = 5;
+
+// Nanoseconds per input of the best of kBestOfRuns runs over inputs.
+// add_input returns a size_t checksum so the work can not be optimized away.
+template <typename AddInput>
+double BestNanoseconds(const std::vector<std::string>& inputs,
+                       AddInput add_input) {
+  auto best = std::chrono::duration<double>::max();
+  for (auto run = 0; run < kBestOfRuns; ++run) {
+    const auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (const auto& input : inputs) {
+      checksum += add_input(input);
+    }
+    const volatile auto result = checksum;
+    static_cast<void>(result);
+    best = std::min(best, std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start));
+  }
+  return best.count() * 1e9 / static_cast<double>(inputs.size());
+}
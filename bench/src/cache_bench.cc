@@ -0,0 +1,65 @@
+#include <cache_bench.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <best_nanoseconds.h>
+#include <caching_string_calculator.h>
+#include <string_calculator.h>
+
+static const auto kHeaders = 256u;
+static const auto kDistinctInputs = 2048u;
+static const auto kNumbersPerInput = 16;
+
+static auto GenerateCalls(size_t count) {
+  std::mt19937 random(2017);
+  std::vector<std::string> inputs(kDistinctInputs);
+  for (auto& input : inputs) {
+    const auto header = random() % kHeaders;
+    input = "//[" + std::to_string(header) + "x][;]\n";
+    for (auto i = 0; i < kNumbersPerInput; ++i) {
+      input += std::to_string(random() % 1000);
+      input += random() % 2 ? std::to_string(header) + "x" : ";";
+    }
+  }
+  std::vector<std::string> calls(count);
+  for (auto& call : calls) {
+    call = inputs[random() % kDistinctInputs];
+  }
+  return calls;
+}
+
+void CachedVersusUncached(size_t calls) {
+  std::printf(
+      "Add on %zu calls of %u inputs with %u headers, best of %d runs\n",
+      calls, kDistinctInputs, kHeaders, kBestOfRuns);
+  const auto numbers = GenerateCalls(calls);
+  CachingStringCalculator all_cached;
+  CachingStringCalculator headers_cached(0);
+  CachingStringCalculator none_cached(0, 0);
+  const auto uncached = BestNanoseconds(numbers, [](const std::string& input) {
+    return static_cast<size_t>(StringCalculator::Add(input));
+  });
+  const auto hits = BestNanoseconds(numbers, [&](const std::string& input) {
+    return static_cast<size_t>(all_cached.Add(input));
+  });
+  const auto header_hits =
+      BestNanoseconds(numbers, [&](const std::string& input) {
+        return static_cast<size_t>(headers_cached.Add(input));
+      });
+  const auto misses =
+      BestNanoseconds(numbers, [&](const std::string& input) {
+        return static_cast<size_t>(none_cached.Add(input));
+      });
+  const auto counters = all_cached.ResultCounters();
+  std::printf("%-28s %10s\n", "", "ns/call");
+  std::printf("%-28s %10.1f\n", "StringCalculator", uncached);
+  std::printf("%-28s %10.1f  (%.1f%% hits)\n", "cached results and headers",
+              hits,
+              100.0 * static_cast<double>(counters.hits) /
+                  static_cast<double>(counters.hits + counters.misses));
+  std::printf("%-28s %10.1f\n", "cached headers", header_hits);
+  std::printf("%-28s %10.1f\n", "nothing cached", misses);
+}
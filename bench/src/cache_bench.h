@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+// Time per call of StringCalculator::Add and of CachingStringCalculator::Add
+// when every input is cached, when only headers are and when nothing is,
+// for calls repeating a few thousand inputs with a few hundred headers.
+void CachedVersusUncached(size_t calls);
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cache_bench.h>
+#include <parallel_add_bench.h>
+#include <report.h>
+#include <try_add_bench.h>
+#include <workload.h>
+#include <workload_bench.h>
+
+static const auto kDefaultMaxSize = size_t{64} << 20;
+static const auto kLargestMaxSize = size_t{1} << 30;
+static const auto kDefaultThreshold = 10.0;
+static const auto kTryAddInputs = size_t{100000};
+static const auto kCacheCalls = size_t{1000000};
+
+static const auto kUsage =
+    "Usage: string_calculator_bench [options]\n"
+    "  --max-size BYTES   largest workload, up to 1 GiB (default 64 MiB)\n"
+    "  --threads N        most threads of ParallelAdd (default: all cores)\n"
+    "  --workloads-only   skip ParallelAdd, TryAdd and cache tables\n"
+    "  --json FILE        write workload results to FILE\n"
+    "  --baseline FILE    compare with results written by --json before\n"
+    "  --threshold PCT    fail if MB/s dropped by more than PCT percent\n"
+    "                     against baseline (default 10)\n";
+
+struct Options {
+  size_t max_size = kDefaultMaxSize;
+  size_t threads = 0;  // All cores.
+  bool workloads_only = false;
+  const char* json = nullptr;  // Paths point into argv.
+  const char* baseline = nullptr;
+  double threshold = kDefaultThreshold;
+};
+
+// Throws std::invalid_argument on anything it does not understand.
+static Options ParseOptions(int argc, char** argv) {
+  Options options;
+  for (auto i = 1; i < argc; ++i) {
+    const std::string_view option = argv[i];
+    if (option == "--workloads-only") {
+      options.workloads_only = true;
+      continue;
+    }
+    if (++i == argc) {
+      throw std::invalid_argument(argv[i - 1]);
+    }
+    const auto value = argv[i];
+    if (option == "--max-size") {
+      options.max_size = std::min(std::stoul(value), kLargestMaxSize);
+    } else if (option == "--threads") {
+      options.threads = std::stoul(value);
+    } else if (option == "--json") {
+      options.json = value;
+    } else if (option == "--baseline") {
+      options.baseline = value;
+    } else if (option == "--threshold") {
+      options.threshold = std::stod(value);
+    } else {
+      throw std::invalid_argument(argv[i - 1]);
+    }
+  }
+  return options;
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = ParseOptions(argc, argv);
+  } catch (const std::exception&) {
+    std::fputs(kUsage, stderr);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Measurement> measurements;
+  for (const auto& workload : DefaultWorkloads(options.max_size)) {
+    measurements.push_back(Measure(workload));
+  }
+  PrintMeasurements(measurements);
+  if (!options.workloads_only) {
+    ParallelAddScaling(options.max_size,
+                       options.threads != 0
+                           ? options.threads
+                           : std::max(std::thread::hardware_concurrency(), 1u));
+    TryAddVersusAdd(kTryAddInputs);
+    CachedVersusUncached(kCacheCalls);
+  }
+
+  try {
+    if (options.json) {
+      WriteJson(measurements, options.json);
+    }
+    if (options.baseline &&
+        ReportRegressions(measurements, ReadBaseline(options.baseline),
+                          options.threshold)) {
+      return EXIT_FAILURE;
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
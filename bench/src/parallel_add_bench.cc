@@ -0,0 +1,52 @@
+#include <parallel_add_bench.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include <string_calculator.h>
+#include <work_stealing_pool.h>
+
+static const auto kRuns = 5;
+
+static auto GenerateNumbers(size_t size) {
+  std::mt19937 random(2017);
+  std::string numbers = "//[***][xx]\n";
+  numbers.reserve(size + 16);
+  while (numbers.size() < size) {
+    numbers += std::to_string(random() % 1000);
+    numbers += random() % 2 ? "***" : "xx";
+  }
+  return numbers;
+}
+
+// Pool is started once, so that runs time adding only.
+static double BestSeconds(const std::string& numbers, size_t threads) {
+  WorkStealingPool pool(threads);
+  auto best = std::chrono::duration<double>::max();
+  for (auto run = 0; run < kRuns; ++run) {
+    const auto start = std::chrono::steady_clock::now();
+    const volatile auto sum = StringCalculator::ParallelAdd(numbers, &pool);
+    static_cast<void>(sum);
+    best = std::min(best, std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start));
+  }
+  return best.count();
+}
+
+void ParallelAddScaling(size_t size, size_t max_threads) {
+  const auto numbers = GenerateNumbers(size);
+  std::printf("ParallelAdd on %zu bytes, best of %d runs\n", numbers.size(),
+              kRuns);
+  std::printf("%8s %12s %8s\n", "threads", "MB/s", "speedup");
+  const auto single_thread_seconds = BestSeconds(numbers, 1);
+  for (size_t threads = 1; threads <= max_threads; ++threads) {
+    const auto seconds =
+        threads == 1 ? single_thread_seconds : BestSeconds(numbers, threads);
+    std::printf("%8zu %12.1f %8.2f\n", threads,
+                static_cast<double>(numbers.size()) / seconds / 1e6,
+                single_thread_seconds / seconds);
+  }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Throughput of StringCalculator::ParallelAdd on generated numbers of given
+// size for every thread count from 1 to max_threads.
+void ParallelAddScaling(size_t size, size_t max_threads);
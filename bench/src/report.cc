@@ -0,0 +1,90 @@
+#include <report.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+static const auto kNameKey = std::string("\"name\": \"");
+static const auto kThroughputKey = std::string("\"mb_per_s\": ");
+
+void PrintMeasurements(const std::vector<Measurement>& measurements) {
+  std::printf("%-50s %10s %12s %10s %10s %10s %8s\n", "workload", "MB/s",
+              "numbers/s", "p50 ns", "p99 ns", "max ns", "allocs");
+  for (const auto& measurement : measurements) {
+    std::printf("%-50s %10.1f %12.3g %10.0f %10.0f %10.0f %8.2f\n",
+                measurement.name.c_str(), measurement.megabytes_per_second,
+                measurement.numbers_per_second, measurement.p50_ns,
+                measurement.p99_ns, measurement.max_ns,
+                measurement.allocations_per_call);
+  }
+}
+
+// Workload names have no characters JSON needs to escape.
+void WriteJson(const std::vector<Measurement>& measurements,
+               const std::string& path) {
+  std::ofstream json(path);
+  json << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < measurements.size(); ++i) {
+    const auto& measurement = measurements[i];
+    json << "    {" << kNameKey << measurement.name << "\", "
+         << "\"bytes\": " << measurement.bytes << ", "
+         << "\"numbers\": " << measurement.numbers << ", "
+         << "\"calls\": " << measurement.calls << ", " << kThroughputKey
+         << measurement.megabytes_per_second << ", "
+         << "\"numbers_per_s\": " << measurement.numbers_per_second << ", "
+         << "\"p50_ns\": " << measurement.p50_ns << ", "
+         << "\"p90_ns\": " << measurement.p90_ns << ", "
+         << "\"p99_ns\": " << measurement.p99_ns << ", "
+         << "\"max_ns\": " << measurement.max_ns << ", "
+         << "\"allocations_per_call\": " << measurement.allocations_per_call
+         << '}' << (i + 1 == measurements.size() ? "" : ",") << '\n';
+  }
+  json << "  ]\n}\n";
+  if (!json.flush()) {
+    throw std::runtime_error("can not write " + path);
+  }
+}
+
+std::map<std::string, double> ReadBaseline(const std::string& path) {
+  std::ifstream json(path);
+  if (!json) {
+    throw std::runtime_error("can not read " + path);
+  }
+  std::map<std::string, double> baseline;
+  std::string line;
+  while (std::getline(json, line)) {
+    const auto name = line.find(kNameKey);
+    const auto throughput = line.find(kThroughputKey);
+    if (name == std::string::npos || throughput == std::string::npos) {
+      continue;
+    }
+    const auto name_begin = name + kNameKey.size();
+    baseline[line.substr(name_begin, line.find('"', name_begin) -
+                                         name_begin)] =
+        std::strtod(line.c_str() + throughput + kThroughputKey.size(),
+                    nullptr);
+  }
+  return baseline;
+}
+
+bool ReportRegressions(const std::vector<Measurement>& measurements,
+                       const std::map<std::string, double>& baseline,
+                       double threshold_percent) {
+  auto regressed = false;
+  for (const auto& measurement : measurements) {
+    const auto it = baseline.find(measurement.name);
+    if (it == std::end(baseline) || it->second <= 0) {
+      continue;
+    }
+    const auto change =
+        (measurement.megabytes_per_second / it->second - 1) * 100;
+    if (change < -threshold_percent) {
+      std::printf("REGRESSION %s: %.1f MB/s, was %.1f MB/s (%+.1f%%)\n",
+                  measurement.name.c_str(), measurement.megabytes_per_second,
+                  it->second, change);
+      regressed = true;
+    }
+  }
+  return regressed;
+}
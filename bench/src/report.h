@@ -0,0 +1,24 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <workload_bench.h>
+
+void PrintMeasurements(const std::vector<Measurement>& measurements);
+
+// One measurement per line of a JSON object, so results of two commits can
+// be compared with any JSON tool and with ReadBaseline. Throws
+// std::runtime_error if the file can not be written.
+void WriteJson(const std::vector<Measurement>& measurements,
+               const std::string& path);
+// MB/s by workload name of a file written by WriteJson. Throws
+// std::runtime_error if the file can not be read.
+std::map<std::string, double> ReadBaseline(const std::string& path);
+
+// Prints every workload whose throughput dropped by more than threshold
+// percent against baseline and returns whether there is any.
+bool ReportRegressions(const std::vector<Measurement>& measurements,
+                       const std::map<std::string, double>& baseline,
+                       double threshold_percent);
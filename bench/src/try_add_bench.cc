@@ -0,0 +1,60 @@
+#include <try_add_bench.h>
+
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <best_nanoseconds.h>
+#include <string_calculator.h>
+
+static const auto kNumbersPerInput = 16;
+static const auto kNegativePercents = {0u, 1u, 50u};
+
+static auto GenerateInputs(size_t count, unsigned negative_percent) {
+  std::mt19937 random(2017);
+  std::vector<std::string> inputs(count);
+  for (auto& input : inputs) {
+    const auto negative = random() % 100 < negative_percent
+                              ? random() % kNumbersPerInput
+                              : kNumbersPerInput;
+    for (unsigned i = 0; i < kNumbersPerInput; ++i) {
+      input += i == negative ? "-" : "";
+      input += std::to_string(random() % 1000);
+      input += random() % 2 ? ',' : '\n';
+    }
+  }
+  return inputs;
+}
+
+void TryAddVersusAdd(size_t inputs) {
+  std::printf("Add and TryAdd on %zu inputs of %d numbers, best of %d runs\n",
+              inputs, kNumbersPerInput, kBestOfRuns);
+  std::printf("%10s %12s %12s %16s\n", "negatives", "Add ns", "TryAdd ns",
+              "TryAdd+msg ns");
+  for (const auto negative_percent : kNegativePercents) {
+    const auto numbers = GenerateInputs(inputs, negative_percent);
+    const auto add = BestNanoseconds(numbers, [](const std::string& input) {
+      try {
+        return static_cast<size_t>(StringCalculator::Add(input));
+      } catch (const std::logic_error& e) {
+        return std::char_traits<char>::length(e.what());
+      }
+    });
+    const auto try_add =
+        BestNanoseconds(numbers, [](const std::string& input) {
+          const auto result = StringCalculator::TryAdd(input);
+          return result.Ok() ? static_cast<size_t>(result.sum)
+                             : result.negative_numbers.size();
+        });
+    const auto try_add_message =
+        BestNanoseconds(numbers, [](const std::string& input) {
+          const auto result = StringCalculator::TryAdd(input);
+          return result.Ok() ? static_cast<size_t>(result.sum)
+                             : result.Message().size();
+        });
+    std::printf("%9u%% %12.1f %12.1f %16.1f\n", negative_percent, add,
+                try_add, try_add_message);
+  }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+// Time per input of StringCalculator::Add, catching its exceptions, and of
+// TryAdd, with and without building messages, for inputs of which 0%, 1% and
+// 50% have a negative number.
+void TryAddVersusAdd(size_t inputs);
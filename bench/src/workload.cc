@@ -0,0 +1,125 @@
+#include <workload.h>
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <vector>
+
+static const auto kSeed = 2017u;
+static const auto kMaxBigNumber = 1000000u;
+static const auto kSizes = {size_t{10}, size_t{1} << 10, size_t{1} << 20,
+                            size_t{64} << 20, size_t{1} << 30};
+static const auto kVariationSize = size_t{1} << 20;
+static const auto kStyles = {DelimiterStyle::kDefault, DelimiterStyle::kSingle,
+                             DelimiterStyle::kMultiple};
+
+static std::string StyleName(DelimiterStyle style) {
+  switch (style) {
+    case DelimiterStyle::kSingle:
+      return "single";
+    case DelimiterStyle::kMultiple:
+      return "multiple";
+    case DelimiterStyle::kDefault:
+    default:
+      return "default";
+  }
+}
+
+static std::string HeaderOf(DelimiterStyle style) {
+  switch (style) {
+    case DelimiterStyle::kSingle:
+      return "//;\n";
+    case DelimiterStyle::kMultiple:
+      return "//[***][xx][z]\n";
+    case DelimiterStyle::kDefault:
+    default:
+      return {};
+  }
+}
+
+static std::vector<std::string> DelimitersOf(DelimiterStyle style) {
+  switch (style) {
+    case DelimiterStyle::kSingle:
+      return {";", "\n"};
+    case DelimiterStyle::kMultiple:
+      return {"***", "xx", "z", "\n"};
+    case DelimiterStyle::kDefault:
+    default:
+      return {",", "\n"};
+  }
+}
+
+std::string NameOf(const Workload& workload) {
+  return StyleName(workload.style) + '/' + std::to_string(workload.size) +
+         "/numbers=" + std::to_string(workload.numbers) +
+         "/big=" + std::to_string(workload.big_percent) +
+         "%/negative=" + std::to_string(workload.negative_percent) + '%';
+}
+
+// Magnitude of the number is padded with zeros to width, which Add ignores.
+static std::string RandomNumber(const Workload& workload,
+                                size_t width,
+                                std::mt19937* random) {
+  const auto kind = (*random)() % 100;
+  std::string sign;
+  std::string digits;
+  if (kind < workload.negative_percent) {
+    sign = "-";
+    digits = std::to_string(1 + (*random)() % 1000);
+  } else if (kind < workload.negative_percent + workload.big_percent) {
+    digits = std::to_string(1001 + (*random)() % kMaxBigNumber);
+  } else {
+    digits = std::to_string((*random)() % 1001);
+  }
+  if (sign.size() + digits.size() < width) {
+    digits.insert(0, width - sign.size() - digits.size(), '0');
+  }
+  return sign + digits;
+}
+
+std::string Generate(const Workload& workload, size_t* count) {
+  assert(count);
+  std::mt19937 random(kSeed);
+  auto numbers = HeaderOf(workload.style);
+  const auto delimiters = DelimitersOf(workload.style);
+  const auto body_size =
+      workload.size > numbers.size() ? workload.size - numbers.size() : 0;
+  // Delimiters are counted as one byte, so padded numbers end up close to
+  // size rather than exactly at it.
+  const auto width =
+      workload.numbers == 0
+          ? 0
+          : std::max(body_size / workload.numbers, size_t{2}) - 1;
+  numbers.reserve(workload.size + 16);
+  for (*count = 0; workload.numbers == 0 || *count < workload.numbers;
+       ++*count) {
+    auto token = RandomNumber(workload, width, &random);
+    token += delimiters[random() % delimiters.size()];
+    if (workload.numbers == 0 &&
+        numbers.size() + token.size() > workload.size) {
+      break;
+    }
+    numbers += token;
+  }
+  return numbers;
+}
+
+std::vector<Workload> DefaultWorkloads(size_t max_size) {
+  std::vector<Workload> workloads;
+  for (const auto size : kSizes) {
+    for (const auto style : kStyles) {
+      if (size <= max_size) {
+        workloads.push_back({size, 0, style, 10, 0});
+      }
+    }
+  }
+  if (kVariationSize <= max_size) {
+    const auto style = DelimiterStyle::kDefault;
+    workloads.push_back({kVariationSize, kVariationSize / 4, style, 10, 0});
+    workloads.push_back({kVariationSize, kVariationSize / 16, style, 10, 0});
+    workloads.push_back({kVariationSize, 0, style, 50, 0});
+    workloads.push_back({kVariationSize, 0, style, 10, 1});
+    workloads.push_back({kVariationSize, 0, style, 10, 50});
+  }
+  return workloads;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum class DelimiterStyle {
+  kDefault,   // ',' and '\n'.
+  kSingle,    // "//;\n".
+  kMultiple,  // "//[***][xx][z]\n".
+};
+
+// Input of StringCalculator::Add generated from a fixed seed, so the same
+// workload is the same input on every run and commit.
+struct Workload {
+  size_t size = 0;     // Bytes, including the header.
+  size_t numbers = 0;  // Padded with zeros to fill size, 0 for natural width.
+  DelimiterStyle style = DelimiterStyle::kDefault;
+  unsigned big_percent = 0;       // Share of numbers above 1000.
+  unsigned negative_percent = 0;  // Share of negative numbers.
+};
+
+// Stable name to match results of different runs, e.g.
+// "multiple/1048576/numbers=0/big=10%/negative=0%".
+std::string NameOf(const Workload& workload);
+// Numbers of workload, count is set to how many numbers there are.
+std::string Generate(const Workload& workload, size_t* count);
+
+// Every delimiter style at sizes from 10 B up to max_size, with 10% of big
+// numbers, and variations of number count, big numbers and negatives at 1 MiB.
+std::vector<Workload> DefaultWorkloads(size_t max_size);
@@ -0,0 +1,62 @@
+#include <workload_bench.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <allocation_counter.h>
+#include <string_calculator.h>
+
+static const auto kMinCalls = size_t{3};
+static const auto kMaxCalls = size_t{200000};
+static const auto kMinSeconds = 0.5;
+
+// Nearest rank percentile of sorted latencies.
+static double Percentile(const std::vector<double>& latencies,
+                         double percent) {
+  const auto rank = static_cast<size_t>(
+      std::ceil(percent / 100 * static_cast<double>(latencies.size())));
+  return latencies[std::max(rank, size_t{1}) - 1];
+}
+
+Measurement Measure(const Workload& workload) {
+  Measurement measurement;
+  measurement.name = NameOf(workload);
+  const auto numbers = Generate(workload, &measurement.numbers);
+  measurement.bytes = numbers.size();
+
+  std::vector<double> latencies;
+  latencies.reserve(kMaxCalls);  // Only calculator allocates while timed.
+  auto seconds = 0.0;
+  size_t checksum = 0;
+  const auto allocations = AllocationCount();
+  while (latencies.size() < kMaxCalls &&
+         (latencies.size() < kMinCalls || seconds < kMinSeconds)) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = StringCalculator::TryAdd(numbers);
+    const auto latency = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start);
+    checksum +=
+        static_cast<size_t>(result.sum) + result.negative_numbers.size();
+    latencies.push_back(latency.count() * 1e9);
+    seconds += latency.count();
+  }
+  const volatile auto result = checksum;
+  static_cast<void>(result);
+
+  measurement.calls = latencies.size();
+  const auto calls = static_cast<double>(measurement.calls);
+  measurement.allocations_per_call =
+      static_cast<double>(AllocationCount() - allocations) / calls;
+  measurement.megabytes_per_second =
+      static_cast<double>(measurement.bytes) * calls / seconds / 1e6;
+  measurement.numbers_per_second =
+      static_cast<double>(measurement.numbers) * calls / seconds;
+  std::sort(std::begin(latencies), std::end(latencies));
+  measurement.p50_ns = Percentile(latencies, 50);
+  measurement.p90_ns = Percentile(latencies, 90);
+  measurement.p99_ns = Percentile(latencies, 99);
+  measurement.max_ns = latencies.back();
+  return measurement;
+}
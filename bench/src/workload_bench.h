@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <workload.h>
+
+struct Measurement {
+  std::string name{};
+  size_t bytes = 0;
+  size_t numbers = 0;
+  size_t calls = 0;
+  double megabytes_per_second = 0;
+  double numbers_per_second = 0;
+  double p50_ns = 0;
+  double p90_ns = 0;
+  double p99_ns = 0;
+  double max_ns = 0;
+  double allocations_per_call = 0;
+};
+
+// Times StringCalculator::TryAdd on input of workload one call at a time,
+// until there are enough calls to tell latency percentiles or the calls took
+// long enough. TryAdd is timed rather than Add so that workloads with
+// negatives measure parsing and not unwinding.
+Measurement Measure(const Workload& workload);
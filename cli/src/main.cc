@@ -0,0 +1,140 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <record_processor.h>
+#include <record_source.h>
+
+static const auto kDefaultBatchSize = size_t{1} << 16;
+
+static const auto kUsage =
+    "Usage: string_calculator_cli [options] [FILE...]\n"
+    "Adds every record of FILEs, or of stdin without FILE or for '-', and\n"
+    "writes one line per record: the sum or \"error: \" and the message.\n"
+    "  --threads N         threads adding records (default: all cores)\n"
+    "  --batch-size N      records read and added at once (default 65536)\n"
+    "  --framing newline   one record per line (default)\n"
+    "  --framing length    4 byte little endian length before every record,\n"
+    "                      for records with '\\n' delimiters\n"
+    "  --errors report     error line for a record and go on (default)\n"
+    "  --errors fail-fast  stop at the first record with an error\n"
+    "Throughput is printed to stderr at the end.\n";
+
+struct Options {
+  size_t threads = 0;  // All cores.
+  size_t batch_size = kDefaultBatchSize;
+  Framing framing = Framing::kNewline;
+  ErrorPolicy errors = ErrorPolicy::kReport;
+  int first_path = 0;  // Index in argv, argc if none.
+};
+
+struct Totals {
+  size_t records = 0;
+  size_t bytes = 0;
+};
+
+// Throws std::invalid_argument on anything it does not understand.
+static Options ParseOptions(int argc, char** argv) {
+  Options options;
+  auto i = 1;
+  for (; i < argc && std::string_view(argv[i]).substr(0, 2) == "--"; ++i) {
+    const std::string_view option = argv[i];
+    if (++i == argc) {
+      throw std::invalid_argument(argv[i - 1]);
+    }
+    const std::string_view value = argv[i];
+    if (option == "--threads") {
+      options.threads = std::stoul(argv[i]);
+    } else if (option == "--batch-size") {
+      options.batch_size = std::max(std::stoul(argv[i]), 1ul);
+    } else if (option == "--framing" && value == "newline") {
+      options.framing = Framing::kNewline;
+    } else if (option == "--framing" && value == "length") {
+      options.framing = Framing::kLengthPrefixed;
+    } else if (option == "--errors" && value == "report") {
+      options.errors = ErrorPolicy::kReport;
+    } else if (option == "--errors" && value == "fail-fast") {
+      options.errors = ErrorPolicy::kFailFast;
+    } else {
+      throw std::invalid_argument(argv[i - 1]);
+    }
+  }
+  options.first_path = i;
+  return options;
+}
+
+// Writes lines of all records of path, nullptr for stdin, to stdout. Returns
+// false if a record with an error stopped it, see ErrorPolicy::kFailFast.
+static bool AddRecords(const char* path,
+                       const Options& options,
+                       RecordProcessor* processor,
+                       Totals* totals) {
+  RecordSource source(path, options.framing);
+  std::vector<std::string_view> records;
+  auto file_records = size_t{0};
+  for (source.NextBatch(options.batch_size, &records); !records.empty();
+       source.NextBatch(options.batch_size, &records)) {
+    const auto processed = processor->Process(records, STDOUT_FILENO);
+    file_records += processed;
+    totals->records += processed;
+    if (processed != records.size()) {
+      std::fprintf(stderr, "%s: record %zu: %s\n", path ? path : "stdin",
+                   file_records + 1, processor->FailFastMessage().c_str());
+      break;
+    }
+  }
+  totals->bytes += source.BytesRead();
+  return processor->Errors() == 0 || options.errors == ErrorPolicy::kReport;
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = ParseOptions(argc, argv);
+  } catch (const std::exception&) {
+    std::fputs(kUsage, stderr);
+    return EXIT_FAILURE;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  RecordProcessor processor(
+      options.threads != 0 ? options.threads
+                           : std::max(std::thread::hardware_concurrency(), 1u),
+      options.errors);
+  Totals totals;
+  auto status = EXIT_SUCCESS;
+  try {
+    auto i = options.first_path;
+    do {
+      const auto path =
+          i < argc && std::string_view(argv[i]) != "-" ? argv[i] : nullptr;
+      if (!AddRecords(path, options, &processor, &totals)) {
+        status = EXIT_FAILURE;
+        break;
+      }
+    } while (++i < argc);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    status = EXIT_FAILURE;
+  }
+
+  const auto seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  std::fprintf(stderr,
+               "%zu records, %zu errors, %zu bytes in %.3f s: %.1f MB/s, "
+               "%.3g records/s\n",
+               totals.records, processor.Errors(), totals.bytes, seconds,
+               static_cast<double>(totals.bytes) / seconds / 1e6,
+               static_cast<double>(totals.records) / seconds);
+  return status;
+}
@@ -0,0 +1,110 @@
+#include <record_processor.h>
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <system_error>
+
+static const auto kSlicesPerThread = size_t{4};
+static const auto kMinSliceRecords = size_t{1024};
+
+// Writes all of buffers, which are left pointing past what was written.
+static void WriteAll(int file, std::vector<iovec>* buffers) {
+  auto buffer = buffers->data();
+  const auto end = buffer + buffers->size();
+  while (buffer != end) {
+    const auto count = std::min(end - buffer, std::ptrdiff_t{IOV_MAX});
+    const auto written = writev(file, buffer, static_cast<int>(count));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "write");
+    }
+    auto rest = static_cast<size_t>(written);
+    for (; buffer != end && rest >= buffer->iov_len; ++buffer) {
+      rest -= buffer->iov_len;
+    }
+    if (buffer != end) {
+      buffer->iov_base = static_cast<char*>(buffer->iov_base) + rest;
+      buffer->iov_len -= rest;
+    }
+  }
+}
+
+RecordProcessor::RecordProcessor(size_t threads, ErrorPolicy policy)
+    : policy_(policy),
+      pool_(threads),
+      slices_(kSlicesPerThread * pool_.Threads()),
+      errors_(0),
+      fail_fast_message_() {}
+
+RecordProcessor::~RecordProcessor() = default;
+
+size_t RecordProcessor::Process(const std::vector<std::string_view>& records,
+                                int file) {
+  const auto count = records.size();
+  const auto slices = std::min(
+      slices_.size(), (count + kMinSliceRecords - 1) / kMinSliceRecords);
+  pool_.Run(slices, [&](size_t i) {
+    auto& slice = slices_[i];
+    try {
+      slice.allocation_error = nullptr;
+      ProcessSlice(records.data(), count * i / slices,
+                   count * (i + 1) / slices, &slice);
+    } catch (...) {
+      slice.allocation_error = std::current_exception();
+    }
+  });
+
+  auto processed = count;
+  std::vector<iovec> buffers;
+  for (size_t i = 0; i < slices; ++i) {
+    auto& slice = slices_[i];
+    if (slice.allocation_error) {
+      std::rethrow_exception(slice.allocation_error);
+    }
+    buffers.push_back({slice.output.data(), slice.output.size()});
+    errors_ += slice.errors;
+    if (policy_ == ErrorPolicy::kFailFast && slice.errors != 0) {
+      processed = slice.first_error;
+      fail_fast_message_ = slice.first_error_message;
+      break;
+    }
+  }
+  WriteAll(file, &buffers);
+  return processed;
+}
+
+void RecordProcessor::ProcessSlice(const std::string_view* records,
+                                   size_t begin,
+                                   size_t end,
+                                   Slice* slice) const {
+  slice->results.resize(end - begin);
+  slice->calculator.AddBatch(records + begin, slice->results.data(),
+                             end - begin);
+  slice->output.clear();
+  slice->errors = 0;
+  for (size_t i = 0; i < end - begin; ++i) {
+    const auto& result = slice->results[i];
+    if (result.error == AddError::kNone) {
+      char sum[16];
+      const auto sum_end = std::to_chars(sum, sum + sizeof(sum), result.sum);
+      slice->output.append(sum, sum_end.ptr);
+      slice->output += '\n';
+      continue;
+    }
+    ++slice->errors;
+    if (policy_ == ErrorPolicy::kFailFast) {
+      slice->first_error = begin + i;
+      slice->first_error_message = slice->calculator.ErrorMessage(result);
+      return;
+    }
+    slice->output += "error: ";
+    slice->output += slice->calculator.ErrorMessage(result);
+    slice->output += '\n';
+  }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <batch_string_calculator.h>
+#include <work_stealing_pool.h>
+
+enum class ErrorPolicy {
+  kReport,    // Error line in place of the sum, go on with next records.
+  kFailFast,  // Stop at the first record with an error.
+};
+
+// Adds records on a pool of threads and writes one line per record in order
+// of records: the sum or "error: " and the message StringCalculator::Add
+// throws. Every slice of a batch is added and formatted by one thread into
+// its own buffer, and buffers are written with a single gather write.
+class RecordProcessor {
+ public:
+  RecordProcessor(size_t threads, ErrorPolicy policy);
+  RecordProcessor(const RecordProcessor&) = delete;
+  RecordProcessor& operator=(const RecordProcessor&) = delete;
+  ~RecordProcessor();
+
+  // Writes lines of records to file and returns how many. With kFailFast
+  // that is the index of the first record with an error if there is one.
+  // Throws std::system_error if lines can not be written and
+  // std::bad_alloc if a thread runs out of memory.
+  size_t Process(const std::vector<std::string_view>& records, int file);
+
+  // Records with an error so far. With kFailFast, one at most.
+  size_t Errors() const { return errors_; }
+  // Message of the record that stopped Process, see kFailFast.
+  const std::string& FailFastMessage() const { return fail_fast_message_; }
+
+ private:
+  struct Slice {
+    BatchStringCalculator calculator{};
+    std::vector<BatchResult> results{};
+    std::string output{};
+    size_t errors = 0;
+    // Record that stopped the slice with kFailFast, index in batch.
+    size_t first_error = 0;
+    std::string first_error_message{};
+    std::exception_ptr allocation_error{};  // Rethrown by calling thread.
+  };
+
+  void ProcessSlice(const std::string_view* records,
+                    size_t begin,
+                    size_t end,
+                    Slice* slice) const;
+
+  ErrorPolicy policy_;
+  WorkStealingPool pool_;
+  std::vector<Slice> slices_;
+  size_t errors_;
+  std::string fail_fast_message_;
+};
@@ -0,0 +1,161 @@
+#include <record_source.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+static const auto kBlockSize = size_t{8} << 20;
+static const auto kLengthSize = size_t{4};
+
+static std::system_error SystemError(const char* what) {
+  return std::system_error(errno, std::generic_category(), what);
+}
+
+static int OpenFile(const char* path) {
+  if (!path) {
+    return STDIN_FILENO;
+  }
+  const auto file = open(path, O_RDONLY | O_CLOEXEC);
+  if (file == -1) {
+    throw SystemError(path);
+  }
+  return file;
+}
+
+RecordSource::RecordSource(const char* path, Framing framing)
+    : RecordSource(OpenFile(path), path != nullptr, framing) {}
+
+RecordSource::RecordSource(int file, Framing framing)
+    : RecordSource(file, false, framing) {}
+
+RecordSource::RecordSource(int file, bool owns_file, Framing framing)
+    : framing_(framing),
+      file_(file),
+      owns_file_(owns_file),
+      mapping_(nullptr),
+      mapping_size_(0),
+      buffer_(),
+      unparsed_(),
+      consumed_(0),
+      end_of_input_(false) {
+  struct stat status;
+  if (fstat(file_, &status) == 0 && S_ISREG(status.st_mode) &&
+      status.st_size > 0) {
+    mapping_size_ = static_cast<size_t>(status.st_size);
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, file_, 0);
+    if (mapping_ == MAP_FAILED) {
+      const auto error = SystemError("mmap");
+      if (owns_file_) {
+        close(file_);
+      }
+      throw error;
+    }
+    madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+    unparsed_ = std::string_view(static_cast<const char*>(mapping_),
+                                 mapping_size_);
+    end_of_input_ = true;
+  } else {
+    buffer_.resize(kBlockSize);
+  }
+}
+
+RecordSource::~RecordSource() {
+  if (mapping_) {
+    munmap(mapping_, mapping_size_);
+  }
+  if (owns_file_) {
+    close(file_);
+  }
+}
+
+void RecordSource::NextBatch(size_t batch_size,
+                             std::vector<std::string_view>* records) {
+  records->clear();
+  while (records->size() < batch_size) {
+    std::string_view record;
+    size_t length = 0;
+    if (!NextRecord(unparsed_, &record, &length)) {
+      // Refill moves unparsed input, so records taken already would dangle.
+      if (!records->empty() || !Refill()) {
+        return;
+      }
+      continue;
+    }
+    records->push_back(record);
+    unparsed_.remove_prefix(length);
+    consumed_ += length;
+  }
+}
+
+bool RecordSource::NextRecord(std::string_view data,
+                              std::string_view* record,
+                              size_t* length) const {
+  switch (framing_) {
+    case Framing::kNewline: {
+      const auto end = data.find('\n');
+      if (end != std::string_view::npos) {
+        *record = data.substr(0, end);
+        *length = end + 1;
+        return true;
+      }
+      if (!end_of_input_ || data.empty()) {
+        return false;
+      }
+      *record = data;  // Last line without '\n'.
+      *length = data.size();
+      return true;
+    }
+    case Framing::kLengthPrefixed:
+    default: {
+      if (data.size() >= kLengthSize) {
+        uint32_t size = 0;
+        for (size_t i = kLengthSize; i > 0; --i) {
+          size = size << 8 | static_cast<unsigned char>(data[i - 1]);
+        }
+        if (data.size() - kLengthSize >= size) {
+          *record = data.substr(kLengthSize, size);
+          *length = kLengthSize + size;
+          return true;
+        }
+      }
+      if (end_of_input_ && !data.empty()) {
+        throw std::runtime_error("last record is cut short");
+      }
+      return false;
+    }
+  }
+}
+
+bool RecordSource::Refill() {
+  if (end_of_input_) {
+    return false;
+  }
+  const auto kept = unparsed_.size();
+  if (kept != 0) {
+    std::memmove(buffer_.data(), unparsed_.data(), kept);
+  }
+  if (kept == buffer_.size()) {
+    buffer_.resize(2 * buffer_.size());  // Record longer than a block.
+  }
+  auto size = kept;
+  while (size < buffer_.size() && !end_of_input_) {
+    const auto count =
+        read(file_, buffer_.data() + size, buffer_.size() - size);
+    if (count > 0) {
+      size += static_cast<size_t>(count);
+    } else if (count == 0) {
+      end_of_input_ = true;
+    } else if (errno != EINTR) {
+      throw SystemError("read");
+    }
+  }
+  unparsed_ = std::string_view(buffer_.data(), size);
+  return true;
+}
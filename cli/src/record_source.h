@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+enum class Framing {
+  kNewline,         // One record per line, so records can not contain '\n'.
+  kLengthPrefixed,  // 4 byte little endian length, then that many bytes.
+};
+
+// Records of a file or of stdin, read in batches. Regular files are memory
+// mapped and records point into the mapping, pipes are read in large blocks
+// and records point into the block, so no record is ever copied.
+class RecordSource {
+ public:
+  // Reads stdin if path is nullptr. Throws std::system_error if the file can
+  // not be opened or mapped.
+  RecordSource(const char* path, Framing framing);
+  // Reads file that is already open, it is not closed.
+  RecordSource(int file, Framing framing);
+  RecordSource(const RecordSource&) = delete;
+  RecordSource& operator=(const RecordSource&) = delete;
+  ~RecordSource();
+
+  // Replaces records with up to batch_size next records, none at the end of
+  // input. Records stay valid until the next call. Throws std::system_error
+  // if input can not be read and std::runtime_error if the last record is
+  // cut short.
+  void NextBatch(size_t batch_size, std::vector<std::string_view>* records);
+
+  // Bytes of input records have been taken from so far.
+  size_t BytesRead() const { return consumed_; }
+
+ private:
+  RecordSource(int file, bool owns_file, Framing framing);
+
+  // Next record of data and its length with framing, false if data has no
+  // complete record.
+  bool NextRecord(std::string_view data,
+                  std::string_view* record,
+                  size_t* length) const;
+  // Reads more of a pipe after the unparsed rest of the buffer, false at the
+  // end of input.
+  bool Refill();
+
+  Framing framing_;
+  int file_;
+  bool owns_file_;
+  void* mapping_;  // Whole file, nullptr if not a regular file.
+  size_t mapping_size_;
+  std::vector<char> buffer_;  // Block of a pipe.
+  std::string_view unparsed_;
+  size_t consumed_;
+  bool end_of_input_;
+};
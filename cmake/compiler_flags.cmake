@@ -67,7 +67,7 @@ if (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
     add_compiler_flags (-Weverything)
     add_compiler_flags (-Qunused-arguments -fcolor-diagnostics)
 
-    if (${CMAKE_CXX_STANDARD} MATCHES "11|14" AND
+    if (${CMAKE_CXX_STANDARD} MATCHES "11|14|17" AND
         ${CMAKE_CXX_STANDARD_REQUIRED})
         add_compiler_flags (-Wno-c++98-compat)
     endif ()
@@ -0,0 +1,66 @@
+#include <add_result.h>
+
+#include <stdexcept>
+
+void AddResult::ShiftPositions(size_t first_negative, size_t offset) {
+  for (auto i = first_negative; i < negative_numbers.size(); ++i) {
+    negative_numbers[i].position += offset;
+  }
+}
+
+void AddResult::Finish() {
+  if (error == AddError::kNone && !negative_numbers.empty()) {
+    error = AddError::kNegativeNumbers;
+  } else if (error != AddError::kNone) {
+    sum = 0;
+    negative_numbers.clear();
+  }
+}
+
+std::string AddResult::Message() const {
+  return ErrorMessage(error, negative_numbers.data(), negative_numbers.size());
+}
+
+std::string ErrorMessage(AddError error,
+                         const NegativeNumber* negative_numbers,
+                         size_t count) {
+  INSTRUMENT_STAGE(PipelineStage::kReport, 0);
+  switch (error) {
+    case AddError::kNegativeNumbers: {
+      INSTRUMENT_COUNT(PipelineCounter::kAllocations, 1);
+      std::string message = "negatives not allowed: ";
+      for (size_t i = 0; i < count; ++i) {
+        message += std::to_string(negative_numbers[i].value) + ' ';
+      }
+      return message;
+    }
+    case AddError::kInvalidNumber:
+    case AddError::kNumberOutOfRange:
+      return "stoi";
+    case AddError::kInvalidHeader:
+      return "empty delimiters header";
+    case AddError::kNone:
+    default:
+      return {};
+  }
+}
+
+void ReportError(const AddResult& result) {
+  if (result.Ok()) {
+    return;
+  }
+  INSTRUMENT_STAGE(PipelineStage::kReport, 0);
+  INSTRUMENT_COUNT(PipelineCounter::kExceptions, 1);
+  switch (result.error) {
+    case AddError::kNegativeNumbers:
+      throw std::logic_error(result.Message());
+    case AddError::kInvalidNumber:
+      throw std::invalid_argument(result.Message());
+    case AddError::kNumberOutOfRange:
+    case AddError::kInvalidHeader:
+      throw std::out_of_range(result.Message());
+    case AddError::kNone:
+    default:
+      return;
+  }
+}
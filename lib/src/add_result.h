@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <instrumentation.h>
+
+// Why numbers have no sum. Each error stands for the exception
+// StringCalculator::Add throws for it.
+enum class AddError {
+  kNone,
+  kNegativeNumbers,   // std::logic_error listing negatives.
+  kInvalidNumber,     // std::invalid_argument("stoi").
+  kNumberOutOfRange,  // std::out_of_range("stoi").
+  kInvalidHeader      // std::out_of_range("empty delimiters header").
+};
+
+struct NegativeNumber {
+  int value;
+  size_t position;  // Offset of its token from the beginning of input.
+};
+
+// Sum of parsed numbers and negatives in order they appeared. Parsing stops
+// at the first malformed number and may be continued on the next part of the
+// same numbers otherwise.
+struct AddResult {
+  static constexpr int kMaxNumber = 1000;
+
+  bool Ok() const { return error == AddError::kNone; }
+
+  void Add(int number, size_t position) {
+    if (number < 0) {
+      AddNegative(number, position);
+    } else if (number <= kMaxNumber) {
+      sum += number;
+    }
+  }
+  void AddNegative(int number, size_t position) {
+    INSTRUMENT_COUNT(PipelineCounter::kAllocations,
+                     negative_numbers.size() == negative_numbers.capacity());
+    negative_numbers.push_back({number, position});
+  }
+  // Negatives from first_negative on were parsed from a part of input that
+  // starts at offset.
+  void ShiftPositions(size_t first_negative, size_t offset);
+  // Called once all numbers are parsed. Negatives become an error, after any
+  // other error sum and negatives mean nothing and are dropped.
+  void Finish();
+  // Text of exception StringCalculator::Add throws for the error, empty
+  // without one. Built only here, parsing never formats anything.
+  std::string Message() const;
+
+  AddError error = AddError::kNone;
+  int sum = 0;
+  std::vector<NegativeNumber> negative_numbers{};
+};
+
+// Message of error with given negatives, same as AddResult::Message.
+std::string ErrorMessage(AddError error,
+                         const NegativeNumber* negative_numbers,
+                         size_t count);
+// Throws exception of StringCalculator::Add for error of result if it has one.
+void ReportError(const AddResult& result);
@@ -0,0 +1,72 @@
+#include <batch_string_calculator.h>
+
+BatchStringCalculator::BatchStringCalculator()
+    : parsed_(), headers_(), next_evicted_header_(0) {}
+
+BatchStringCalculator::~BatchStringCalculator() = default;
+
+void BatchStringCalculator::AddBatch(const std::string_view* inputs,
+                                     BatchResult* results,
+                                     size_t count) {
+  parsed_.negative_numbers.clear();
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = Add(inputs[i]);
+  }
+}
+
+std::string BatchStringCalculator::ErrorMessage(
+    const BatchResult& result) const {
+  return ::ErrorMessage(result.error, Negatives(result),
+                        result.negatives_count);
+}
+
+BatchResult BatchStringCalculator::Add(std::string_view numbers) {
+  BatchResult result;
+  const auto header = DelimiterSet::HeaderOf(numbers);
+  numbers.remove_prefix(header.size());
+  if (!header.empty() && !DelimiterSet::HasDelimiters(header)) {
+    result.error = AddError::kInvalidHeader;
+    return result;
+  }
+
+  auto& negatives = parsed_.negative_numbers;
+  result.negatives_begin = negatives.size();
+  parsed_.sum = 0;
+  if (header.empty()) {
+    ParseNumbers(numbers, &parsed_);
+  } else {
+    ParseNumbers(numbers, Delimiters(header), &parsed_);
+  }
+
+  if (!parsed_.Ok()) {
+    result.error = parsed_.error;
+    parsed_.error = AddError::kNone;
+    negatives.resize(result.negatives_begin);
+    return result;
+  }
+  parsed_.ShiftPositions(result.negatives_begin, header.size());
+  result.negatives_count = negatives.size() - result.negatives_begin;
+  if (result.negatives_count != 0) {
+    result.error = AddError::kNegativeNumbers;
+    return result;
+  }
+  result.sum = parsed_.sum;
+  return result;
+}
+// Inputs of a batch usually share few headers, each of them is parsed once
+// and reused by following inputs and batches.
+const DelimiterSet& BatchStringCalculator::Delimiters(std::string_view header) {
+  for (const auto& delimiters : headers_) {
+    if (delimiters.Header() == header) {
+      return delimiters;
+    }
+  }
+  if (headers_.size() < kMaxCachedHeaders) {
+    headers_.emplace_back(header);
+    return headers_.back();
+  }
+  auto& evicted = headers_[next_evicted_header_];
+  next_evicted_header_ = (next_evicted_header_ + 1) % kMaxCachedHeaders;
+  evicted = DelimiterSet(header);
+  return evicted;
+}
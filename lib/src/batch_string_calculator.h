@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <delimiter_set.h>
+#include <numbers_parser.h>
+
+// Outcome of one input of a batch, errors are reported instead of thrown.
+// Negatives of all inputs share storage of the calculator.
+struct BatchResult {
+  AddError error = AddError::kNone;
+  int sum = 0;  // Only meaningful without error.
+  size_t negatives_begin = 0;
+  size_t negatives_count = 0;
+};
+
+// StringCalculator::Add for many small inputs. Scratch memory and parsed
+// headers are kept between batches, so once they have grown to what inputs
+// need nothing is allocated. Meant to be owned by a single thread.
+class BatchStringCalculator {
+ public:
+  BatchStringCalculator();
+  BatchStringCalculator(const BatchStringCalculator&) = delete;
+  BatchStringCalculator& operator=(const BatchStringCalculator&) = delete;
+  ~BatchStringCalculator();
+
+  // Adds inputs[i] into results[i] for every i in [0, count).
+  void AddBatch(const std::string_view* inputs,
+                BatchResult* results,
+                size_t count);
+
+  // Negatives of result of the last batch in order they appeared.
+  const NegativeNumber* Negatives(const BatchResult& result) const {
+    return parsed_.negative_numbers.data() + result.negatives_begin;
+  }
+  // Message of exception StringCalculator::Add would throw, empty if none.
+  std::string ErrorMessage(const BatchResult& result) const;
+
+ private:
+  static constexpr size_t kMaxCachedHeaders = 64;
+
+  BatchResult Add(std::string_view numbers);
+  const DelimiterSet& Delimiters(std::string_view header);
+
+  AddResult parsed_;  // Negatives of all inputs of the last batch.
+  std::vector<DelimiterSet> headers_;
+  size_t next_evicted_header_;
+};
@@ -0,0 +1,48 @@
+#include <caching_string_calculator.h>
+
+#include <string_calculator.h>
+
+CachingStringCalculator::CachingStringCalculator(size_t result_capacity,
+                                                 size_t header_capacity)
+    : results_(result_capacity), headers_(header_capacity) {}
+
+CachingStringCalculator::~CachingStringCalculator() = default;
+
+int CachingStringCalculator::Add(std::string_view numbers) {
+  const auto result = TryAdd(numbers);
+  ReportError(result);
+  return result.sum;
+}
+
+AddResult CachingStringCalculator::TryAdd(std::string_view numbers) {
+  if (numbers.size() > kMaxCachedSize) {
+    return AddUncached(numbers);
+  }
+  const auto hash = HashBytes(numbers);
+  AddResult result;
+  if (!results_.Find(hash, numbers, &result)) {
+    result = AddUncached(numbers);
+    results_.Insert(hash, numbers, result);
+  }
+  return result;
+}
+
+// StringCalculator::TryAdd with delimiter sets of headers taken from cache.
+// They are shared, so that one evicted by other thread stays alive while it
+// is used here.
+AddResult CachingStringCalculator::AddUncached(std::string_view numbers) {
+  const auto header = DelimiterSet::HeaderOf(numbers);
+  if (header.empty() || !DelimiterSet::HasDelimiters(header)) {
+    return StringCalculator::TryAdd(numbers);
+  }
+  const auto hash = HashBytes(header);
+  std::shared_ptr<const DelimiterSet> delimiters;
+  if (!headers_.Find(hash, header, &delimiters)) {
+    delimiters = std::make_shared<const DelimiterSet>(header);
+    headers_.Insert(hash, header, delimiters);
+  }
+  auto result =
+      StringCalculator::TryAdd(numbers.substr(header.size()), *delimiters);
+  result.ShiftPositions(0, header.size());
+  return result;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include <add_result.h>
+#include <delimiter_set.h>
+#include <sharded_cache.h>
+
+// StringCalculator for traffic that repeats. Results of short inputs,
+// errors included, are cached by input and parsed delimiter sets by header,
+// so repeated inputs are neither parsed nor added again, and repeated
+// headers are parsed once. Results and exceptions are exactly the ones of
+// StringCalculator. Safe to share between threads.
+class CachingStringCalculator {
+ public:
+  static constexpr size_t kDefaultResultCapacity = 4096;
+  static constexpr size_t kDefaultHeaderCapacity = 512;
+  // Longer inputs are only added, they are unlikely to repeat and copying
+  // them into the cache would cost more than adding them.
+  static constexpr size_t kMaxCachedSize = 1024;
+
+  // Capacities are numbers of results and of headers kept, zero to cache
+  // none of them.
+  explicit CachingStringCalculator(
+      size_t result_capacity = kDefaultResultCapacity,
+      size_t header_capacity = kDefaultHeaderCapacity);
+  CachingStringCalculator(const CachingStringCalculator&) = delete;
+  CachingStringCalculator& operator=(const CachingStringCalculator&) = delete;
+  ~CachingStringCalculator();
+
+  // Same as StringCalculator::Add, a cached error is thrown again.
+  int Add(std::string_view numbers);
+  // Same as StringCalculator::TryAdd.
+  AddResult TryAdd(std::string_view numbers);
+
+  // Inputs longer than kMaxCachedSize are not counted.
+  CacheCounters ResultCounters() const { return results_.Counters(); }
+  CacheCounters HeaderCounters() const { return headers_.Counters(); }
+
+ private:
+  AddResult AddUncached(std::string_view numbers);
+
+  ShardedCache<AddResult> results_;
+  ShardedCache<std::shared_ptr<const DelimiterSet>> headers_;
+};
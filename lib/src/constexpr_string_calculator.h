@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+
+#include <delimiter_set.h>
+#include <string_calculator.h>
+
+// DelimiterSet that can be built at compile time. Delimiters are kept
+// longest first, so the first one that matches is the longest one, and are
+// views into the header, which has to outlive the set.
+class ConstexprDelimiterSet {
+ public:
+  static constexpr size_t kMaxDelimiters = 16;  // Including '\n'.
+
+  // Default ',' and '\n' delimiters of input without header.
+  constexpr ConstexprDelimiterSet()
+      : header_(), delimiters_{",", "\n"}, count_(2), valid_(true) {}
+  // Invalid if DelimiterSet(header) throws or there are too many delimiters.
+  [[gnu::noinline]] constexpr explicit ConstexprDelimiterSet(
+      std::string_view header)
+      : header_(header), delimiters_(), count_(0), valid_(false) {
+    if (header.size() <= 2 || header.substr(0, 2) != "//" ||
+        header.find('\n') != header.size() - 1) {
+      return;
+    }
+    auto delimiters = header.substr(2, header.size() - 3);
+    if (!delimiters.empty() && delimiters.front() == '[') {
+      delimiters.remove_prefix(1);
+    }
+    if (delimiters.empty()) {
+      return;
+    }
+    if (delimiters.back() == ']') {
+      delimiters.remove_suffix(1);
+    }
+    while (!delimiters.empty()) {
+      const auto end = delimiters.find("][");
+      const auto delimiter = delimiters.substr(0, end);
+      if (!delimiter.empty() && !Append(delimiter)) {
+        return;
+      }
+      delimiters.remove_prefix(end == std::string_view::npos ? delimiters.size()
+                                                             : end + 2);
+    }
+    valid_ = Append("\n");
+  }
+
+  constexpr bool Valid() const { return valid_; }
+  // Empty for default delimiters.
+  constexpr std::string_view Header() const { return header_; }
+
+  // Length of the longest delimiter rest starts with or zero if none.
+  constexpr size_t MatchLength(std::string_view rest) const {
+    for (size_t i = 0; i < count_; ++i) {
+      if (rest.compare(0, delimiters_[i].size(), delimiters_[i]) == 0) {
+        return delimiters_[i].size();
+      }
+    }
+    return 0;
+  }
+
+ private:
+  // Inserts delimiter after all that are at least as long.
+  constexpr bool Append(std::string_view delimiter) {
+    if (count_ == kMaxDelimiters) {
+      return false;
+    }
+    auto i = count_++;
+    for (; i > 0 && delimiters_[i - 1].size() < delimiter.size(); --i) {
+      delimiters_[i] = delimiters_[i - 1];
+    }
+    delimiters_[i] = delimiter;
+    return true;
+  }
+
+  std::string_view header_;
+  std::array<std::string_view, kMaxDelimiters> delimiters_;
+  size_t count_;
+  bool valid_;
+};
+
+// StringCalculator::Add that folds to a constant for constant numbers.
+// Numbers Add reports an error for, and headers with more than
+// kMaxDelimiters delimiters, are left to StringCalculator::Add, which is not
+// constexpr. So negatives or malformed numbers in a constant are a compile
+// error, while at run time the same exceptions are thrown. Functions with
+// loops are not inlined into run time callers, which does not change what
+// they fold to in constant ones.
+class ConstexprStringCalculator {
+ public:
+  [[gnu::noinline]] static constexpr int Add(std::string_view numbers) {
+    const auto header = HeaderOf(numbers);
+    const auto delimiters = header.empty() ? ConstexprDelimiterSet()
+                                           : ConstexprDelimiterSet(header);
+    int sum = 0;
+    if (!delimiters.Valid() ||
+        !Sum(numbers.substr(header.size()), delimiters, &sum)) {
+      return StringCalculator::Add(numbers);
+    }
+    return sum;
+  }
+  // Numbers without header, split by delimiters.
+  [[gnu::noinline]] static constexpr int Add(
+      std::string_view numbers,
+      const ConstexprDelimiterSet& delimiters) {
+    int sum = 0;
+    if (!delimiters.Valid() || !Sum(numbers, delimiters, &sum)) {
+      return StringCalculator::Add(numbers,
+                                   delimiters.Header().empty()
+                                       ? DelimiterSet()
+                                       : DelimiterSet(delimiters.Header()));
+    }
+    return sum;
+  }
+
+ private:
+  static constexpr std::string_view HeaderOf(std::string_view numbers) {
+    if (numbers.size() > 2 && numbers.substr(0, 2) == "//") {
+      const auto new_line = numbers.find('\n');
+      if (new_line != std::string_view::npos) {
+        return numbers.substr(0, new_line + 1);
+      }
+    }
+    return {};
+  }
+
+  static constexpr bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+  }
+
+  // Same contract as ToInt, false where it reports an error.
+  static constexpr bool ToInt(std::string_view token, int* value) {
+    size_t pos = 0;
+    while (pos < token.size() && IsSpace(token[pos])) {
+      ++pos;
+    }
+    const auto negative = pos < token.size() && token[pos] == '-';
+    if (pos < token.size() && (token[pos] == '-' || token[pos] == '+')) {
+      ++pos;
+    }
+    const auto limit =
+        static_cast<long long>(std::numeric_limits<int>::max()) + negative;
+    const auto digits_begin = pos;
+    long long magnitude = 0;
+    for (; pos < token.size() && token[pos] >= '0' && token[pos] <= '9';
+         ++pos) {
+      magnitude = magnitude * 10 + (token[pos] - '0');
+      if (magnitude > limit) {
+        return false;
+      }
+    }
+    if (pos == digits_begin) {
+      return false;
+    }
+    *value = static_cast<int>(negative ? -magnitude : magnitude);
+    return true;
+  }
+
+  // Sum of numbers, false if any of them is negative or malformed.
+  [[gnu::noinline]] static constexpr bool Sum(
+      std::string_view numbers,
+      const ConstexprDelimiterSet& delimiters,
+      int* sum) {
+    size_t token_begin = 0;
+    for (size_t pos = 0; pos <= numbers.size();) {
+      const auto length =
+          pos < numbers.size() ? delimiters.MatchLength(numbers.substr(pos))
+                               : 0;
+      if (length == 0 && pos < numbers.size()) {
+        ++pos;
+        continue;
+      }
+      if (pos == numbers.size() && token_begin == pos) {
+        break;  // Empty token after the last delimiter is ignored.
+      }
+      int value = 0;
+      if (!ToInt(numbers.substr(token_begin, pos - token_begin), &value) ||
+          value < 0) {
+        return false;
+      }
+      *sum += value <= AddResult::kMaxNumber ? value : 0;
+      pos += length == 0 ? 1 : length;
+      token_begin = pos;
+    }
+    return true;
+  }
+};
+
+// Add for numbers without header split by delimiters of a header known at
+// compile time, so no header is parsed at run time:
+//   static constexpr char kHeader[] = "//[***][xx]\n";
+//   static_assert(StringCalculatorFor<kHeader>::Add("1***2xx3") == 6);
+// C++17 takes no string literals as template arguments, so header is an array
+// with static storage duration.
+template <const char* Header>
+class StringCalculatorFor {
+ public:
+  static constexpr ConstexprDelimiterSet kDelimiters{std::string_view(Header)};
+  static_assert(kDelimiters.Valid(),
+                "header must be \"//...\\n\" with at most 15 delimiters");
+
+  static constexpr int Add(std::string_view numbers) {
+    return ConstexprStringCalculator::Add(numbers, kDelimiters);
+  }
+};
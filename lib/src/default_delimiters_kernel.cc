@@ -0,0 +1,194 @@
+#include <default_delimiters_kernel.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include <instrumentation.h>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__GNUC__) && \
+    !defined(FORCE_SCALAR_PARSER)
+#define X86_PARSER_KERNELS
+#include <immintrin.h>
+#endif
+
+#if defined(X86_PARSER_KERNELS)
+
+static const auto kMaxShortDigits = 9u;  // Any 9 digits fit into int.
+
+// pshufb masks moving first n bytes to the end of vector and zeroing the rest.
+static const auto kAlignDigitsMasks = [] {
+  std::array<std::array<char, 16>, kMaxShortDigits + 1> masks{};
+  for (size_t count = 0; count < masks.size(); ++count) {
+    for (size_t i = 0; i < masks[count].size(); ++i) {
+      masks[count][i] = i + count >= masks[count].size()
+                            ? static_cast<char>(i + count - masks[count].size())
+                            : static_cast<char>(0x80);
+    }
+  }
+  return masks;
+}();
+
+// Converts token of optional '-' and up to 9 digits with a single load. Gives
+// up on anything else and when load would cross the end of numbers.
+[[gnu::target("sse4.2"), gnu::always_inline]] static inline bool
+ParseShortToken(const char* token,
+                size_t length,
+                const char* end,
+                int* value) {
+  const auto negative = length != 0 && *token == '-';
+  const auto digits = token + negative;
+  const auto count = length - negative;
+  if (count == 0 || count > kMaxShortDigits || end - digits < 16) {
+    return false;
+  }
+
+  const auto chars =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+  const auto is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                    _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+  const auto digit_mask = static_cast<unsigned>(_mm_movemask_epi8(is_digit));
+  const auto expected_mask = (1u << count) - 1;
+  if ((digit_mask & expected_mask) != expected_mask) {
+    return false;
+  }
+
+  auto v = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  v = _mm_shuffle_epi8(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                              kAlignDigitsMasks[count].data())));
+  v = _mm_maddubs_epi16(v, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10,
+                                         1, 10, 1, 10, 1));
+  v = _mm_madd_epi16(v, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  v = _mm_packus_epi32(v, v);
+  v = _mm_madd_epi16(v, _mm_setr_epi16(10000, 1, 10000, 1, 0, 0, 0, 0));
+  const auto magnitude =
+      _mm_cvtsi128_si32(v) * 100000000 + _mm_extract_epi32(v, 1);
+  *value = negative ? -magnitude : magnitude;
+  return true;
+}
+
+[[gnu::target("sse4.2"), gnu::always_inline]] static inline bool AddToken(
+    const char* numbers,
+    const char* token,
+    const char* delimiter,
+    const char* end,
+    int* sum,
+    AddResult* parsed) {
+  const auto length = static_cast<size_t>(delimiter - token);
+  int value = 0;
+  if (!ParseShortToken(token, length, end, &value)) {
+    parsed->error = ToInt(std::string_view(token, length), &value);
+    if (parsed->error != AddError::kNone) {
+      return false;
+    }
+  }
+  INSTRUMENT_COUNT(PipelineCounter::kTokens, 1);
+  const auto is_small =
+      static_cast<unsigned>(value) <=
+      static_cast<unsigned>(AddResult::kMaxNumber);
+  *sum += value & -static_cast<int>(is_small);  // Negatives are huge unsigned.
+  if (value < 0) {
+    parsed->AddNegative(value, static_cast<size_t>(token - numbers));
+  }
+  return true;
+}
+
+// Offsets of negatives found by ParseNumbersScalar in the tail are counted
+// from the tail, they are moved to be offsets in numbers.
+static void ParseTail(std::string_view numbers,
+                      const char* tail,
+                      AddResult* parsed) {
+  const auto tail_begin = static_cast<size_t>(tail - numbers.data());
+  const auto first_negative = parsed->negative_numbers.size();
+  ParseNumbersScalar(numbers.substr(tail_begin), parsed);
+  parsed->ShiftPositions(first_negative, tail_begin);
+}
+
+[[gnu::target("sse4.2")]] static void ParseNumbersSse42(
+    std::string_view numbers,
+    AddResult* parsed) {
+  const auto end = numbers.data() + numbers.size();
+  const auto commas = _mm_set1_epi8(',');
+  const auto new_lines = _mm_set1_epi8('\n');
+  auto token = numbers.data();
+  auto sum = parsed->sum;
+  for (auto block = numbers.data(); end - block >= 16; block += 16) {
+    const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    auto delimiters = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, commas),
+                                       _mm_cmpeq_epi8(chars, new_lines))));
+    for (; delimiters != 0; delimiters &= delimiters - 1) {
+      const auto delimiter = block + __builtin_ctz(delimiters);
+      if (!AddToken(numbers.data(), token, delimiter, end, &sum, parsed)) {
+        return;
+      }
+      token = delimiter + 1;
+    }
+  }
+  parsed->sum = sum;
+  ParseTail(numbers, token, parsed);
+}
+
+[[gnu::target("avx2")]] static void ParseNumbersAvx2(std::string_view numbers,
+                                                     AddResult* parsed) {
+  const auto end = numbers.data() + numbers.size();
+  const auto commas = _mm256_set1_epi8(',');
+  const auto new_lines = _mm256_set1_epi8('\n');
+  auto token = numbers.data();
+  auto sum = parsed->sum;
+  for (auto block = numbers.data(); end - block >= 32; block += 32) {
+    const auto chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    auto delimiters = static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chars, commas),
+                        _mm256_cmpeq_epi8(chars, new_lines))));
+    for (; delimiters != 0; delimiters &= delimiters - 1) {
+      const auto delimiter = block + __builtin_ctz(delimiters);
+      if (!AddToken(numbers.data(), token, delimiter, end, &sum, parsed)) {
+        return;
+      }
+      token = delimiter + 1;
+    }
+  }
+  parsed->sum = sum;
+  ParseTail(numbers, token, parsed);
+}
+
+#endif
+
+InstructionSet SupportedInstructionSet() {
+#if defined(X86_PARSER_KERNELS)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return InstructionSet::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return InstructionSet::kSse42;
+  }
+#endif
+  return InstructionSet::kScalar;
+}
+
+void ParseNumbers(std::string_view numbers,
+                  InstructionSet instruction_set,
+                  AddResult* parsed) {
+  assert(parsed);
+  switch (instruction_set) {
+#if defined(X86_PARSER_KERNELS)
+    case InstructionSet::kAvx2:
+      ParseNumbersAvx2(numbers, parsed);
+      return;
+    case InstructionSet::kSse42:
+      ParseNumbersSse42(numbers, parsed);
+      return;
+#else
+    case InstructionSet::kAvx2:
+    case InstructionSet::kSse42:
+#endif
+    case InstructionSet::kScalar:
+    default:
+      ParseNumbersScalar(numbers, parsed);
+      return;
+  }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string_view>
+
+#include <numbers_parser.h>
+
+enum class InstructionSet { kScalar, kSse42, kAvx2 };
+
+// Widest instruction set of the running CPU. Always kScalar when built with
+// FORCE_SCALAR_PARSER or for a CPU other than x86-64.
+InstructionSet SupportedInstructionSet();
+
+// Numbers split by ',' and '\n' parsed with given instruction set, which has
+// to be supported by the running CPU. Vector kernels find delimiters a block
+// at a time and convert short numbers with a few vector instructions, other
+// numbers are left to ToInt, so results and errors are identical to
+// ParseNumbersScalar.
+void ParseNumbers(std::string_view numbers,
+                  InstructionSet instruction_set,
+                  AddResult* parsed);
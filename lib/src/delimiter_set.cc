@@ -0,0 +1,120 @@
+#include <delimiter_set.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <instrumentation.h>
+
+static const auto kLineDelimiter = '\n';
+
+static auto SplitByDelim(std::string_view s, std::string_view delim) {
+  std::vector<std::string> elems;
+  size_t pos = 0;
+  while ((pos = s.find(delim)) != std::string_view::npos) {
+    if (pos != 0) {
+      elems.emplace_back(s.substr(0, pos));  // Empty delimiters are useless.
+    }
+    s.remove_prefix(pos + delim.length());
+  }
+  if (!s.empty()) {
+    elems.emplace_back(s);  // If no delim occured should return whole string.
+  }
+
+  return elems;
+}
+
+// Text after "//" and optional '[', up to "\n". Empty means a header without
+// delimiters, a lone ']' does not.
+static auto RemoveOpeningTags(std::string_view header) {
+  header.remove_prefix(2);
+  header.remove_suffix(1);
+  if (!header.empty() && header.front() == '[') {
+    header.remove_prefix(1);
+  }
+  return header;
+}
+
+static auto RemoveTagsFromDelimiters(std::string_view header) {
+  auto delimiters = RemoveOpeningTags(header);
+  if (!delimiters.empty() && delimiters.back() == ']') {
+    delimiters.remove_suffix(1);
+  }
+  return delimiters;
+}
+
+DelimiterSet::DelimiterSet()
+    : header_(),
+      delimiters_{",", {kLineDelimiter}},
+      first_byte_begin_(),
+      max_length_(),
+      used_bytes_() {
+  Compile();
+}
+
+DelimiterSet::DelimiterSet(std::string_view header)
+    : header_(header),
+      delimiters_(),
+      first_byte_begin_(),
+      max_length_(),
+      used_bytes_() {
+  INSTRUMENT_STAGE(PipelineStage::kHeader, header.size());
+  INSTRUMENT_COUNT(PipelineCounter::kAllocations, 1);
+  if (HeaderOf(header).size() != header.size()) {
+    throw std::invalid_argument("not a delimiters header");
+  }
+  if (!HasDelimiters(header)) {
+    // Same type as std::string::at threw here before headers were parsed in
+    // place, but with a message that does not depend on the standard library.
+    throw std::out_of_range("empty delimiters header");
+  }
+  delimiters_ = SplitByDelim(RemoveTagsFromDelimiters(header), "][");
+  delimiters_.emplace_back(1, kLineDelimiter);
+  Compile();
+}
+
+DelimiterSet::DelimiterSet(const DelimiterSet& other) = default;
+DelimiterSet::DelimiterSet(DelimiterSet&& other) noexcept = default;
+DelimiterSet& DelimiterSet::operator=(const DelimiterSet& other) = default;
+DelimiterSet& DelimiterSet::operator=(DelimiterSet&& other) noexcept = default;
+DelimiterSet::~DelimiterSet() = default;
+
+bool DelimiterSet::HasDelimiters(std::string_view header) {
+  return !RemoveOpeningTags(header).empty();
+}
+
+std::string_view DelimiterSet::HeaderOf(std::string_view numbers) {
+  if (numbers.size() > 2 && numbers[0] == '/' && numbers[1] == '/') {
+    const auto new_line = numbers.find(kLineDelimiter);
+    if (new_line != std::string_view::npos) {
+      return numbers.substr(0, new_line + 1);
+    }
+  }
+  return {};
+}
+
+void DelimiterSet::Compile() {
+  static const auto kFirstThenLongest = [](const std::string& lhs,
+                                           const std::string& rhs) {
+    if (lhs.front() != rhs.front()) {
+      return static_cast<unsigned char>(lhs.front()) <
+             static_cast<unsigned char>(rhs.front());
+    }
+    return lhs.size() != rhs.size() ? lhs.size() > rhs.size() : lhs < rhs;
+  };
+  std::sort(std::begin(delimiters_), std::end(delimiters_), kFirstThenLongest);
+  delimiters_.erase(
+      std::unique(std::begin(delimiters_), std::end(delimiters_)),
+      std::end(delimiters_));
+
+  first_byte_begin_.fill(0);
+  for (const auto& delimiter : delimiters_) {
+    max_length_ = std::max(max_length_, delimiter.size());
+    for (const auto c : delimiter) {
+      used_bytes_.set(static_cast<unsigned char>(c));
+    }
+    ++first_byte_begin_[static_cast<unsigned char>(delimiter.front()) + 1u];
+  }
+  for (size_t i = 1; i < first_byte_begin_.size(); ++i) {
+    first_byte_begin_[i] += first_byte_begin_[i - 1];
+  }
+}
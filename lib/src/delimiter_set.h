@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Delimiters of a "//[d1][d2]...\n" header compiled into a jump table indexed
+// by the first byte of a delimiter, so every position of the input is checked
+// only against delimiters that can start there. Build it once and reuse it for
+// all inputs that share the header.
+class DelimiterSet {
+ public:
+  // Default ',' and '\n' delimiters of input without header.
+  DelimiterSet();
+  // Throws std::invalid_argument if header is not "//...\n" and
+  // std::out_of_range if there is nothing between "//" and "\n".
+  explicit DelimiterSet(std::string_view header);
+  DelimiterSet(const DelimiterSet& other);
+  DelimiterSet(DelimiterSet&& other) noexcept;
+  DelimiterSet& operator=(const DelimiterSet& other);
+  DelimiterSet& operator=(DelimiterSet&& other) noexcept;
+  ~DelimiterSet();
+
+  // Header at the beginning of numbers or empty view if there is none.
+  static std::string_view HeaderOf(std::string_view numbers);
+  // Whether header of numbers has anything between "//" and "\n", so
+  // DelimiterSet(header) does not throw.
+  static bool HasDelimiters(std::string_view header);
+
+  bool IsDefault() const { return header_.empty(); }
+  const std::string& Header() const { return header_; }
+  size_t MaxLength() const { return max_length_; }
+  // Whether c occurs anywhere in any of delimiters.
+  bool Contains(char c) const {
+    return used_bytes_[static_cast<unsigned char>(c)];
+  }
+
+  // Length of the longest delimiter rest starts with or zero if none. '\n'
+  // always separates numbers, even with custom delimiters. Rest must not be
+  // empty, callers only ask at positions inside numbers.
+  size_t MatchLength(std::string_view rest) const {
+    assert(!rest.empty());
+    const auto first = static_cast<unsigned char>(rest.front());
+    for (auto i = first_byte_begin_[first]; i != first_byte_begin_[first + 1u];
+         ++i) {
+      const auto& delimiter = delimiters_[i];
+      if (rest.compare(0, delimiter.size(), delimiter) == 0) {
+        return delimiter.size();
+      }
+    }
+    return 0;
+  }
+
+ private:
+  void Compile();
+
+  std::string header_;
+  std::vector<std::string> delimiters_;  // By first byte, longest first.
+  std::array<uint32_t, 257> first_byte_begin_;
+  size_t max_length_;
+  std::bitset<256> used_bytes_;
+};
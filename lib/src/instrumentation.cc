@@ -0,0 +1,175 @@
+#include <instrumentation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#if defined(PIPELINE_INSTRUMENTATION) && \
+    (defined(__x86_64__) || defined(_M_X64)) && defined(__GNUC__)
+#define TIME_STAMP_COUNTER
+#include <x86intrin.h>
+#elif defined(PIPELINE_INSTRUMENTATION)
+#include <chrono>
+#endif
+
+static const char* const kStageNames[kPipelineStages] = {"header", "parse",
+                                                         "report"};
+static const char* const kCounterNames[kPipelineCounters] = {
+    "tokens", "allocations", "exceptions"};
+
+std::string PrometheusText(const InstrumentationSnapshot& snapshot) {
+  std::string text;
+  const auto add_stage_metric = [&](const char* name, const char* help,
+                                    uint64_t StageCounters::*value) {
+    text += std::string("# HELP string_calculator_stage_") + name +
+            "_total " + help + "\n# TYPE string_calculator_stage_" + name +
+            "_total counter\n";
+    for (size_t stage = 0; stage < kPipelineStages; ++stage) {
+      text += std::string("string_calculator_stage_") + name +
+              "_total{stage=\"" + kStageNames[stage] + "\"} " +
+              std::to_string(snapshot.stages[stage].*value) + '\n';
+    }
+  };
+  add_stage_metric("calls", "Times the stage ran.", &StageCounters::calls);
+  add_stage_metric("cycles", "Time stamp counter ticks spent in the stage.",
+                   &StageCounters::cycles);
+  add_stage_metric("bytes", "Bytes of input the stage processed.",
+                   &StageCounters::bytes);
+  for (size_t counter = 0; counter < kPipelineCounters; ++counter) {
+    const auto name =
+        std::string("string_calculator_") + kCounterNames[counter] + "_total";
+    text += "# TYPE " + name + " counter\n" + name + ' ' +
+            std::to_string(snapshot.counters[counter]) + '\n';
+  }
+  return text;
+}
+
+#if defined(PIPELINE_INSTRUMENTATION)
+
+namespace {
+
+struct AtomicStageCounters {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> cycles{0};
+  std::atomic<uint64_t> bytes{0};
+};
+
+// Written only by its own thread with relaxed loads and stores, so updates
+// are plain moves, and read by snapshots from any thread.
+struct ThreadCounters {
+  ThreadCounters();
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+  ~ThreadCounters();
+
+  void Add(std::atomic<uint64_t>* counter, uint64_t count) {
+    counter->store(counter->load(std::memory_order_relaxed) + count,
+                   std::memory_order_relaxed);
+  }
+
+  std::array<AtomicStageCounters, kPipelineStages> stages{};
+  std::array<std::atomic<uint64_t>, kPipelineCounters> counters{};
+  std::array<unsigned, kPipelineStages> depth{};  // Of nested timers.
+};
+
+struct Registry {
+  std::mutex mutex{};
+  std::vector<const ThreadCounters*> threads{};
+  InstrumentationSnapshot retired{};  // Of threads that are gone.
+};
+
+}  // namespace
+
+// Never destroyed, threads may outlive static objects.
+static Registry& GetRegistry() {
+  static auto& registry = *new Registry;
+  return registry;
+}
+
+static void AddTo(const ThreadCounters& thread,
+                  InstrumentationSnapshot* snapshot) {
+  for (size_t stage = 0; stage < kPipelineStages; ++stage) {
+    auto& counters = snapshot->stages[stage];
+    const auto& values = thread.stages[stage];
+    counters.calls += values.calls.load(std::memory_order_relaxed);
+    counters.cycles += values.cycles.load(std::memory_order_relaxed);
+    counters.bytes += values.bytes.load(std::memory_order_relaxed);
+  }
+  for (size_t counter = 0; counter < kPipelineCounters; ++counter) {
+    snapshot->counters[counter] +=
+        thread.counters[counter].load(std::memory_order_relaxed);
+  }
+}
+
+ThreadCounters::ThreadCounters() {
+  auto& registry = GetRegistry();
+  const std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+  auto& registry = GetRegistry();
+  const std::lock_guard<std::mutex> lock(registry.mutex);
+  AddTo(*this, &registry.retired);
+  auto& threads = registry.threads;
+  threads.erase(std::find(std::begin(threads), std::end(threads), this));
+}
+
+static ThreadCounters& CurrentThreadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+static uint64_t Now() {
+#if defined(TIME_STAMP_COUNTER)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+void CountEvent(PipelineCounter counter, uint64_t count) {
+  auto& counters = CurrentThreadCounters();
+  counters.Add(&counters.counters[static_cast<size_t>(counter)], count);
+}
+
+StageTimer::StageTimer(PipelineStage stage, size_t bytes)
+    : stage_(stage),
+      bytes_(bytes),
+      outermost_(
+          CurrentThreadCounters().depth[static_cast<size_t>(stage)]++ == 0),
+      start_(outermost_ ? Now() : 0) {}
+
+StageTimer::~StageTimer() {
+  auto& counters = CurrentThreadCounters();
+  const auto stage = static_cast<size_t>(stage_);
+  --counters.depth[stage];
+  if (outermost_) {
+    auto& values = counters.stages[stage];
+    counters.Add(&values.cycles, Now() - start_);
+    counters.Add(&values.calls, 1);
+    counters.Add(&values.bytes, bytes_);
+  }
+}
+
+InstrumentationSnapshot TakeInstrumentationSnapshot() {
+  auto& registry = GetRegistry();
+  const std::lock_guard<std::mutex> lock(registry.mutex);
+  auto snapshot = registry.retired;
+  for (const auto thread : registry.threads) {
+    AddTo(*thread, &snapshot);
+  }
+  return snapshot;
+}
+
+#else
+
+InstrumentationSnapshot TakeInstrumentationSnapshot() {
+  return {};
+}
+
+#endif
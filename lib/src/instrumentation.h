@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Stages of the Add pipeline. Splitting numbers, converting and filtering
+// them are one pass in the parsers, so they are one stage.
+enum class PipelineStage { kHeader, kParse, kReport };
+enum class PipelineCounter {
+  kTokens,       // Numbers parsed.
+  kAllocations,  // Delimiter sets built, negatives grown, messages built.
+  kExceptions,   // Thrown to report an error.
+};
+
+constexpr size_t kPipelineStages = 3;
+constexpr size_t kPipelineCounters = 3;
+
+struct StageCounters {
+  uint64_t calls = 0;
+  uint64_t cycles = 0;  // Time stamp counter ticks, nanoseconds off x86.
+  uint64_t bytes = 0;
+};
+
+struct InstrumentationSnapshot {
+  std::array<StageCounters, kPipelineStages> stages{};
+  std::array<uint64_t, kPipelineCounters> counters{};
+};
+
+// Counters are collected only when built with PIPELINE_INSTRUMENTATION,
+// otherwise instrumented code is compiled exactly as without it and
+// snapshots are all zero.
+constexpr bool InstrumentationEnabled() {
+#if defined(PIPELINE_INSTRUMENTATION)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Sum of counters of all threads, including threads that are gone. Every
+// thread only writes its own counters, so taking a snapshot does not stop
+// them and may miss updates in progress.
+InstrumentationSnapshot TakeInstrumentationSnapshot();
+// Snapshot in Prometheus text exposition format.
+std::string PrometheusText(const InstrumentationSnapshot& snapshot);
+
+#if defined(PIPELINE_INSTRUMENTATION)
+
+void CountEvent(PipelineCounter counter, uint64_t count);
+
+// Adds time from construction to destruction to stage. Stages nested in the
+// same stage, like parsers calling each other, are counted once.
+class StageTimer {
+ public:
+  StageTimer(PipelineStage stage, size_t bytes);
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+  ~StageTimer();
+
+ private:
+  PipelineStage stage_;
+  size_t bytes_;
+  bool outermost_;
+  uint64_t start_;
+};
+
+#define INSTRUMENT_STAGE_NAME(line) stage_timer_##line
+#define INSTRUMENT_STAGE_AT(stage, bytes, line) \
+  const StageTimer INSTRUMENT_STAGE_NAME(line)(stage, bytes)
+#define INSTRUMENT_STAGE(stage, bytes) \
+  INSTRUMENT_STAGE_AT(stage, bytes, __LINE__)
+#define INSTRUMENT_COUNT(counter, count) \
+  CountEvent(counter, static_cast<uint64_t>(count))
+
+#else
+
+// Arguments are not evaluated, so disabled instrumentation costs nothing.
+#define INSTRUMENT_STAGE(stage, bytes) static_cast<void>(0)
+#define INSTRUMENT_COUNT(counter, count) static_cast<void>(0)
+
+#endif
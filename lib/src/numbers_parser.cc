@@ -0,0 +1,178 @@
+#include <numbers_parser.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include <default_delimiters_kernel.h>
+#include <instrumentation.h>
+
+static const auto kDefaultDelimiter = ',';
+static const auto kLineDelimiter = '\n';
+
+static bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+static bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static const auto kLimit =
+    static_cast<unsigned long long>(std::numeric_limits<int>::max()) + 1;
+
+static auto AddDigit(unsigned long long value, char digit) {
+  if (value > kLimit) {
+    return value;  // Saturated, enough to report out of range.
+  }
+  return value * 10 + static_cast<unsigned long long>(digit - '0');
+}
+
+static AddError ToCheckedInt(unsigned long long value,
+                             bool negative,
+                             int* checked) {
+  if (value > (negative ? kLimit : kLimit - 1)) {
+    return AddError::kNumberOutOfRange;
+  }
+  *checked = negative ? static_cast<int>(-static_cast<long long>(value))
+                      : static_cast<int>(value);
+  return AddError::kNone;
+}
+
+AddError ToInt(std::string_view token, int* value) {
+  assert(value);
+  auto it = std::find_if_not(std::begin(token), std::end(token), IsSpace);
+  const auto negative = it != std::end(token) && *it == '-';
+  if (it != std::end(token) && (*it == '-' || *it == '+')) {
+    ++it;
+  }
+
+  const auto digits_begin = it;
+  unsigned long long magnitude = 0;
+  for (; it != std::end(token) && IsDigit(*it); ++it) {
+    magnitude = AddDigit(magnitude, *it);
+  }
+
+  if (it == digits_begin) {
+    return AddError::kInvalidNumber;
+  }
+  return ToCheckedInt(magnitude, negative, value);
+}
+
+void TokenParser::Feed(std::string_view piece) {
+  empty_ = empty_ && piece.empty();
+  for (const auto c : piece) {
+    switch (stage_) {
+      case Stage::kSpaces:
+        if (IsSpace(c)) {
+          break;
+        }
+        if (c == '-' || c == '+') {
+          negative_ = c == '-';
+          stage_ = Stage::kSign;
+          break;
+        }
+        stage_ = IsDigit(c) ? Stage::kDigits : Stage::kInvalid;
+        value_ = IsDigit(c) ? AddDigit(value_, c) : value_;
+        break;
+      case Stage::kSign:
+        stage_ = IsDigit(c) ? Stage::kDigits : Stage::kInvalid;
+        value_ = IsDigit(c) ? AddDigit(value_, c) : value_;
+        break;
+      case Stage::kDigits:
+        if (IsDigit(c)) {
+          value_ = AddDigit(value_, c);
+        } else {
+          stage_ = Stage::kTail;
+        }
+        break;
+      case Stage::kTail:
+      case Stage::kInvalid:
+      default:
+        return;  // Nothing after digits or garbage can change the result.
+    }
+  }
+}
+
+AddError TokenParser::Finish(int* value) {
+  assert(value);
+  const auto stage = stage_;
+  const auto negative = negative_;
+  const auto magnitude = value_;
+  *this = TokenParser();
+  if (stage != Stage::kDigits && stage != Stage::kTail) {
+    return AddError::kInvalidNumber;
+  }
+  return ToCheckedInt(magnitude, negative, value);
+}
+
+static size_t DefaultDelimiterLength(std::string_view rest) {
+  return rest.front() == kDefaultDelimiter || rest.front() == kLineDelimiter;
+}
+
+static bool AddToken(std::string_view numbers,
+                     size_t token_begin,
+                     size_t token_end,
+                     AddResult* parsed) {
+  int value = 0;
+  parsed->error =
+      ToInt(numbers.substr(token_begin, token_end - token_begin), &value);
+  if (parsed->error != AddError::kNone) {
+    return false;
+  }
+  INSTRUMENT_COUNT(PipelineCounter::kTokens, 1);
+  parsed->Add(value, token_begin);
+  return true;
+}
+
+// Walks the numbers once, converting every token as soon as its delimiter is
+// found. An empty token after the last delimiter is ignored, any other empty
+// token is an error.
+template <typename DelimiterLength>
+static void ParseTokens(std::string_view numbers,
+                        DelimiterLength delimiter_length,
+                        AddResult* parsed) {
+  assert(parsed);
+  size_t token_begin = 0;
+  for (size_t pos = 0; pos < numbers.size();) {
+    const auto length = delimiter_length(numbers.substr(pos));
+    if (length == 0) {
+      ++pos;
+      continue;
+    }
+    if (!AddToken(numbers, token_begin, pos, parsed)) {
+      return;
+    }
+    pos += length;
+    token_begin = pos;
+  }
+  if (token_begin < numbers.size()) {
+    AddToken(numbers, token_begin, numbers.size(), parsed);
+  }
+}
+
+void ParseNumbers(std::string_view numbers, AddResult* parsed) {
+  INSTRUMENT_STAGE(PipelineStage::kParse, numbers.size());
+  static const auto kInstructionSet = SupportedInstructionSet();
+  ParseNumbers(numbers, kInstructionSet, parsed);
+}
+
+void ParseNumbersScalar(std::string_view numbers, AddResult* parsed) {
+  ParseTokens(numbers, DefaultDelimiterLength, parsed);
+}
+
+void ParseNumbers(std::string_view numbers,
+                  const DelimiterSet& delimiters,
+                  AddResult* parsed) {
+  INSTRUMENT_STAGE(PipelineStage::kParse, numbers.size());
+  if (delimiters.IsDefault()) {
+    ParseNumbers(numbers, parsed);
+    return;
+  }
+  ParseTokens(numbers,
+              [&](std::string_view rest) {
+                return delimiters.MatchLength(rest);
+              },
+              parsed);
+}
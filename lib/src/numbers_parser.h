@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+
+#include <add_result.h>
+#include <delimiter_set.h>
+
+// Same contract as std::stoi: leading whitespace and an optional sign are
+// accepted, anything after the digits is ignored. Returns kInvalidNumber or
+// kNumberOutOfRange where std::stoi throws, value is set only without error.
+AddError ToInt(std::string_view token, int* value);
+
+// ToInt of a token that arrives in pieces. Keeps only a few words of state no
+// matter how long the token is.
+class TokenParser {
+ public:
+  void Feed(std::string_view piece);
+  bool Empty() const { return empty_; }
+  // Converts everything fed since last call and starts a new token.
+  AddError Finish(int* value);
+
+ private:
+  enum class Stage { kSpaces, kSign, kDigits, kTail, kInvalid };
+
+  Stage stage_ = Stage::kSpaces;
+  bool empty_ = true;
+  bool negative_ = false;
+  unsigned long long value_ = 0;
+};
+
+// Numbers split by ',' and '\n', parsed by fastest kernel the CPU supports.
+// Positions of negatives are offsets in numbers.
+void ParseNumbers(std::string_view numbers, AddResult* parsed);
+// Byte by byte parsing of numbers split by ',' and '\n'.
+void ParseNumbersScalar(std::string_view numbers, AddResult* parsed);
+void ParseNumbers(std::string_view numbers,
+                  const DelimiterSet& delimiters,
+                  AddResult* parsed);
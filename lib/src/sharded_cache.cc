@@ -0,0 +1,27 @@
+#include <sharded_cache.h>
+
+#include <cstring>
+
+static const auto kMultiplier = uint64_t{0x9e3779b97f4a7c15};
+
+static uint64_t Mix(uint64_t hash, uint64_t word) {
+  hash = (hash ^ word) * kMultiplier;
+  return hash ^ hash >> 32;
+}
+
+uint64_t HashBytes(std::string_view bytes) {
+  auto hash = uint64_t{bytes.size()} * kMultiplier;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes.data() + i, sizeof(word));
+    hash = Mix(hash, word);
+  }
+  if (i != bytes.size()) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+    hash = Mix(hash, word);
+  }
+  // Both halves are used, high bits pick a shard and low ones a bucket.
+  return Mix(hash, 0) * kMultiplier;
+}
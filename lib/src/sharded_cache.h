@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct CacheCounters {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;  // Entries replaced by an entry of other key.
+};
+
+// Fast hash of bytes, 8 at a time, for keys of caches.
+uint64_t HashBytes(std::string_view bytes);
+
+// Values by string key, bounded by capacity. Keys are spread over shards by
+// their hash and every shard has its own lock, so threads looking up
+// different keys rarely wait for each other. Once a shard is full, its
+// oldest entry is evicted. Keys are compared in full, so colliding hashes
+// are only a miss.
+template <typename Value>
+class ShardedCache {
+ public:
+  static constexpr unsigned kShardBits = 4;
+  static constexpr size_t kShards = size_t{1} << kShardBits;
+
+  // Capacity is the number of entries kept by all shards together, the
+  // first capacity % kShards shards keep one more than the others. Nothing
+  // is cached with zero capacity.
+  explicit ShardedCache(size_t capacity);
+  ShardedCache(const ShardedCache&) = delete;
+  ShardedCache& operator=(const ShardedCache&) = delete;
+  ~ShardedCache();
+
+  // Copies value of key with given hash, false if it is not cached.
+  bool Find(uint64_t hash, std::string_view key, Value* value);
+  void Insert(uint64_t hash, std::string_view key, const Value& value);
+
+  // Sum of counters of all shards.
+  CacheCounters Counters() const;
+
+ private:
+  // Entries are in order of insertion, as a ring.
+  struct alignas(64) Shard {
+    mutable std::mutex mutex{};
+    std::unordered_map<uint64_t, size_t> entry_of_hash{};
+    std::vector<uint64_t> hashes{};
+    std::vector<std::string> keys{};
+    std::vector<Value> values{};
+    size_t capacity = 0;
+    size_t next_evicted = 0;
+    CacheCounters counters{};
+  };
+
+  Shard& ShardOf(uint64_t hash) { return shards_[hash >> (64 - kShardBits)]; }
+
+  std::vector<Shard> shards_;
+};
+
+template <typename Value>
+ShardedCache<Value>::ShardedCache(size_t capacity)
+    : shards_(kShards) {
+  for (size_t i = 0; i < kShards; ++i) {
+    auto& shard = shards_[i];
+    shard.capacity = capacity / kShards + (i < capacity % kShards);
+    shard.entry_of_hash.reserve(shard.capacity);
+  }
+}
+
+template <typename Value>
+ShardedCache<Value>::~ShardedCache() = default;
+
+template <typename Value>
+bool ShardedCache<Value>::Find(uint64_t hash,
+                               std::string_view key,
+                               Value* value) {
+  auto& shard = ShardOf(hash);
+  const std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto entry = shard.entry_of_hash.find(hash);
+  if (entry == std::end(shard.entry_of_hash) ||
+      shard.keys[entry->second] != key) {
+    ++shard.counters.misses;
+    return false;
+  }
+  ++shard.counters.hits;
+  *value = shard.values[entry->second];
+  return true;
+}
+
+template <typename Value>
+void ShardedCache<Value>::Insert(uint64_t hash,
+                                 std::string_view key,
+                                 const Value& value) {
+  auto& shard = ShardOf(hash);
+  if (shard.capacity == 0) {
+    return;
+  }
+  const std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto same_hash = shard.entry_of_hash.find(hash);
+  if (same_hash != std::end(shard.entry_of_hash)) {
+    // Other thread added the same key meanwhile, or keys collide.
+    const auto entry = same_hash->second;
+    shard.counters.evictions += shard.keys[entry] != key;
+    shard.keys[entry] = key;
+    shard.values[entry] = value;
+    return;
+  }
+  if (shard.hashes.size() < shard.capacity) {
+    shard.entry_of_hash.emplace(hash, shard.hashes.size());
+    shard.hashes.push_back(hash);
+    shard.keys.emplace_back(key);
+    shard.values.push_back(value);
+    return;
+  }
+  const auto evicted = shard.next_evicted;
+  shard.next_evicted = (evicted + 1) % shard.capacity;
+  ++shard.counters.evictions;
+  shard.entry_of_hash.erase(shard.hashes[evicted]);
+  shard.entry_of_hash.emplace(hash, evicted);
+  shard.hashes[evicted] = hash;
+  shard.keys[evicted] = key;
+  shard.values[evicted] = value;
+}
+
+template <typename Value>
+CacheCounters ShardedCache<Value>::Counters() const {
+  CacheCounters counters;
+  for (const auto& shard : shards_) {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    counters.hits += shard.counters.hits;
+    counters.misses += shard.counters.misses;
+    counters.evictions += shard.counters.evictions;
+  }
+  return counters;
+}
@@ -0,0 +1,344 @@
+#include <streaming_string_calculator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+#include <vector>
+
+#include <instrumentation.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILES
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const auto kDefaultDelimiters = std::string_view(",\n");
+static const auto kReadBufferSize = size_t{1} << 16;
+
+StreamingStringCalculator::StreamingStringCalculator()
+    : stage_(Stage::kHeader),
+      header_(),
+      delimiters_(),
+      carry_(),
+      token_(),
+      parsed_(),
+      position_(0),
+      carry_position_(0),
+      token_position_(0) {}
+
+StreamingStringCalculator::~StreamingStringCalculator() = default;
+
+void StreamingStringCalculator::Feed(std::string_view chunk) {
+  try {
+    auto position = position_;
+    position_ += chunk.size();
+    if (stage_ == Stage::kHeader) {
+      const auto rest = FeedHeader(chunk);
+      position += chunk.size() - rest.size();
+      chunk = rest;
+    }
+    if (stage_ == Stage::kNumbers) {
+      FeedNumbers(chunk, position);
+    }
+  } catch (...) {
+    Reset();
+    throw;
+  }
+}
+
+int StreamingStringCalculator::Finish() {
+  try {
+    if (stage_ == Stage::kHeader) {
+      // Input starts with "//" but has no new line, so it is not a header.
+      stage_ = Stage::kNumbers;
+      const auto numbers = std::move(header_);
+      header_.clear();
+      FeedNumbers(numbers, 0);
+    }
+    if (delimiters_) {
+      ParseCustomNumbers(carry_, carry_position_, carry_.size(), true);
+    }
+    if (!token_.Empty()) {
+      AddToken();  // Empty last number is ignored.
+    }
+    auto parsed = std::move(parsed_);
+    Reset();
+    parsed.Finish();
+    ReportError(parsed);
+    return parsed.sum;
+  } catch (...) {
+    Reset();
+    throw;
+  }
+}
+
+void StreamingStringCalculator::Reset() {
+  stage_ = Stage::kHeader;
+  header_.clear();
+  delimiters_.reset();
+  carry_.clear();
+  token_ = TokenParser();
+  parsed_ = AddResult();
+  position_ = 0;
+  carry_position_ = 0;
+  token_position_ = 0;
+}
+
+// Collects input while it may be a header, returns the rest of chunk once
+// it is known whether there is one.
+std::string_view StreamingStringCalculator::FeedHeader(
+    std::string_view chunk) {
+  while (header_.size() < 2 && !chunk.empty()) {
+    header_ += chunk.front();
+    chunk.remove_prefix(1);
+    if (header_.back() != '/') {
+      stage_ = Stage::kNumbers;
+      const auto numbers = std::move(header_);
+      header_.clear();
+      FeedNumbers(numbers, 0);
+      return chunk;
+    }
+  }
+  if (chunk.empty()) {
+    return chunk;
+  }
+
+  const auto new_line = chunk.find('\n');
+  if (new_line == std::string_view::npos) {
+    header_.append(chunk);
+    return {};
+  }
+  header_.append(chunk.substr(0, new_line + 1));
+  delimiters_.emplace(header_);
+  token_position_ = header_.size();
+  header_.clear();
+  stage_ = Stage::kNumbers;
+  return chunk.substr(new_line + 1);
+}
+
+void StreamingStringCalculator::FeedNumbers(std::string_view chunk,
+                                            size_t position) {
+  INSTRUMENT_STAGE(PipelineStage::kParse, chunk.size());
+  if (delimiters_) {
+    FeedCustomNumbers(chunk, position);
+  } else {
+    FeedDefaultNumbers(chunk, position);
+  }
+}
+
+// Only numbers cut by chunk boundaries go through token_, everything between
+// first and last delimiter of chunk is parsed in place by vector kernels.
+void StreamingStringCalculator::FeedDefaultNumbers(std::string_view chunk,
+                                                   size_t position) {
+  const auto first = chunk.find_first_of(kDefaultDelimiters);
+  if (first == std::string_view::npos) {
+    token_.Feed(chunk);
+    return;
+  }
+  token_.Feed(chunk.substr(0, first));
+  AddToken();
+
+  const auto last = chunk.find_last_of(kDefaultDelimiters);
+  const auto first_negative = parsed_.negative_numbers.size();
+  ParseNumbers(chunk.substr(first + 1, last - first), &parsed_);
+  ReportError(parsed_);
+  parsed_.ShiftPositions(first_negative, position + first + 1);
+  token_.Feed(chunk.substr(last + 1));
+  token_position_ = position + last + 1;
+}
+
+void StreamingStringCalculator::FeedCustomNumbers(std::string_view chunk,
+                                                  size_t position) {
+  if (!carry_.empty()) {
+    // Enough of chunk to decide whether any carried byte starts a delimiter.
+    const auto carried = carry_.size();
+    carry_.append(chunk.substr(0, delimiters_->MaxLength() - 1));
+    const auto parsed =
+        ParseCustomNumbers(carry_, carry_position_, carried, false);
+    if (parsed < carried) {
+      carry_.erase(0, parsed);  // Whole chunk is in carry_ already.
+      carry_position_ += parsed;
+      return;
+    }
+    chunk.remove_prefix(parsed - carried);
+    position += parsed - carried;
+    carry_.clear();
+  }
+  const auto parsed = ParseCustomNumbers(chunk, position, chunk.size(), false);
+  carry_.assign(chunk.substr(parsed));
+  carry_position_ = position + parsed;
+}
+
+// Parses numbers starting before limit and returns where it stopped. Unless
+// it is the last part of input, stops before bytes that are too close to the
+// end to tell whether they start a delimiter.
+size_t StreamingStringCalculator::ParseCustomNumbers(std::string_view numbers,
+                                                     size_t position,
+                                                     size_t limit,
+                                                     bool last) {
+  assert(delimiters_);
+  const auto max_length = delimiters_->MaxLength();
+  size_t token_begin = 0;
+  size_t pos = 0;
+  while (pos < limit && (last || numbers.size() - pos >= max_length)) {
+    const auto length = delimiters_->MatchLength(numbers.substr(pos));
+    if (length == 0) {
+      ++pos;
+      continue;
+    }
+    token_.Feed(numbers.substr(token_begin, pos - token_begin));
+    AddToken();
+    pos += length;
+    token_begin = pos;
+    token_position_ = position + pos;
+  }
+  token_.Feed(numbers.substr(token_begin, pos - token_begin));
+  return pos;
+}
+
+// Numbers are not parsed past a malformed one, so its error is thrown at once.
+void StreamingStringCalculator::AddToken() {
+  int value = 0;
+  parsed_.error = token_.Finish(&value);
+  ReportError(parsed_);
+  INSTRUMENT_COUNT(PipelineCounter::kTokens, 1);
+  parsed_.Add(value, token_position_);
+}
+
+// Feeds file through fixed size buffer, read_chunk returns negative size on
+// error and zero at the end of file.
+template <typename ReadChunk>
+static void FeedReadChunks(ReadChunk read_chunk,
+                           const std::string& path,
+                           StreamingStringCalculator* calculator) {
+  std::vector<char> buffer(kReadBufferSize);
+  for (;;) {
+    const auto size = read_chunk(buffer.data(), buffer.size());
+    if (size < 0) {
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+    if (size == 0) {
+      return;
+    }
+    calculator->Feed(
+        std::string_view(buffer.data(), static_cast<size_t>(size)));
+  }
+}
+
+#if defined(MAPPED_FILES)
+
+namespace {
+
+class FileDescriptor {
+ public:
+  explicit FileDescriptor(const std::string& path)
+      : fd_(open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+    if (fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+  }
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+  ~FileDescriptor() { close(fd_); }
+
+  int Get() const { return fd_; }
+
+ private:
+  int fd_;
+};
+
+class MappedFile {
+ public:
+  MappedFile(int fd, size_t size)
+      : data_(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)),
+        size_(size) {}
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() {
+    if (IsMapped()) {
+      munmap(data_, size_);
+    }
+  }
+
+  bool IsMapped() const { return data_ != MAP_FAILED; }
+  char* Data() const { return static_cast<char*>(data_); }
+
+ private:
+  void* data_;
+  size_t size_;
+};
+
+}  // namespace
+
+static const auto kMappedWindowSize = size_t{1} << 24;
+
+// Feeds file in windows, giving pages of every parsed window back to the
+// kernel so resident memory stays the same for any file size.
+static bool FeedMappedFile(const FileDescriptor& file,
+                           StreamingStringCalculator* calculator) {
+  struct stat info {};
+  if (fstat(file.Get(), &info) != 0 || !S_ISREG(info.st_mode) ||
+      info.st_size <= 0) {
+    return false;
+  }
+  const auto size = static_cast<size_t>(info.st_size);
+  const MappedFile mapped(file.Get(), size);
+  if (!mapped.IsMapped()) {
+    return false;
+  }
+
+  madvise(mapped.Data(), size, MADV_SEQUENTIAL);
+  for (size_t offset = 0; offset < size; offset += kMappedWindowSize) {
+    const auto window = std::min(kMappedWindowSize, size - offset);
+    calculator->Feed(std::string_view(mapped.Data() + offset, window));
+    madvise(mapped.Data() + offset, window, MADV_DONTNEED);
+  }
+  return true;
+}
+
+int StreamingStringCalculator::AddFile(const std::string& path) {
+  StreamingStringCalculator calculator;
+  const FileDescriptor file(path);
+  if (!FeedMappedFile(file, &calculator)) {
+    FeedReadChunks(
+        [&](char* data, size_t size) {
+          auto read_size = read(file.Get(), data, size);
+          while (read_size < 0 && errno == EINTR) {
+            read_size = read(file.Get(), data, size);
+          }
+          return read_size;
+        },
+        path, &calculator);
+  }
+  return calculator.Finish();
+}
+
+#else
+
+int StreamingStringCalculator::AddFile(const std::string& path) {
+  StreamingStringCalculator calculator;
+  const auto stream = std::fopen(path.c_str(), "rb");
+  if (stream == nullptr) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  try {
+    FeedReadChunks(
+        [&](char* data, size_t size) {
+          const auto read_size = std::fread(data, 1, size, stream);
+          return std::ferror(stream) ? -1 : static_cast<long>(read_size);
+        },
+        path, &calculator);
+  } catch (...) {
+    std::fclose(stream);
+    throw;
+  }
+  std::fclose(stream);
+  return calculator.Finish();
+}
+
+#endif
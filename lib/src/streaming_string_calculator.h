@@ -0,0 +1,57 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <delimiter_set.h>
+#include <numbers_parser.h>
+
+// StringCalculator::Add for input that arrives in chunks. Numbers, delimiters
+// and the header may be split between chunks anywhere. Apart from the header
+// and negatives only bytes that may still start a delimiter are kept, so
+// memory does not grow with the input.
+class StreamingStringCalculator {
+ public:
+  StreamingStringCalculator();
+  StreamingStringCalculator(const StreamingStringCalculator&) = delete;
+  StreamingStringCalculator& operator=(const StreamingStringCalculator&) =
+      delete;
+  ~StreamingStringCalculator();
+
+  // Throws as soon as a malformed number is complete, same exceptions as
+  // StringCalculator::Add. Calculator starts over after that.
+  void Feed(std::string_view chunk);
+  // Sum of everything fed since construction or previous Finish. Throws like
+  // StringCalculator::Add. Calculator starts over in any case.
+  int Finish();
+  void Reset();
+
+  // Sum of numbers in file, mapped into memory when possible and read with
+  // fixed size buffer otherwise. Throws std::system_error if it can not be
+  // read.
+  static int AddFile(const std::string& path);
+
+ private:
+  enum class Stage { kHeader, kNumbers };
+
+  std::string_view FeedHeader(std::string_view chunk);
+  void FeedNumbers(std::string_view chunk, size_t position);
+  void FeedDefaultNumbers(std::string_view chunk, size_t position);
+  void FeedCustomNumbers(std::string_view chunk, size_t position);
+  size_t ParseCustomNumbers(std::string_view numbers,
+                            size_t position,
+                            size_t limit,
+                            bool last);
+  void AddToken();
+
+  Stage stage_;
+  std::string header_;  // Beginning of input while it may be a header.
+  std::optional<DelimiterSet> delimiters_;  // Empty for default delimiters.
+  std::string carry_;  // Last bytes that may start a custom delimiter.
+  TokenParser token_;  // Number split between chunks.
+  AddResult parsed_;
+  size_t position_;        // Of the next byte fed, for positions of negatives.
+  size_t carry_position_;  // Of the first byte of carry_.
+  size_t token_position_;  // Of the first byte of token_.
+};
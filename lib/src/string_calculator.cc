@@ -2,136 +2,138 @@
 
 #include <algorithm>
 #include <cassert>
-#include <numeric>
-#include <stdexcept>
+#include <exception>
 #include <vector>
 
-static auto SplitByDelim(std::string s, const std::string& delim) {
-  std::vector<std::string> elems;
-  size_t pos = 0;
-  while ((pos = s.find(delim)) != std::string::npos) {
-    auto elem = s.substr(0, pos);
-    elems.push_back(elem);
-    s.erase(0, pos + delim.length());
-  }
-  if (!s.empty()) {
-    elems.push_back(s);  // If no delim occured should return whole string.
-  }
+#include <numbers_parser.h>
+#include <work_stealing_pool.h>
 
-  return elems;
-}
+static const auto kMinBytesPerThread = size_t{1} << 20;
+static const auto kChunksPerThread = size_t{4};
 
-static auto ReplaceAll(std::string s,
-                       const std::string& search,
-                       const std::string& replace) {
-  for (size_t pos = 0;; pos += replace.length()) {
-    pos = s.find(search, pos);
-    if (pos == std::string::npos) {
-      break;
-    }
-    s.erase(pos, search.length());
-    s.insert(pos, replace);
-  }
-  return s;
+static auto CutOffDelimiters(std::string_view* s) {
+  const auto header = DelimiterSet::HeaderOf(*s);
+  s->remove_prefix(header.size());
+  return header;
 }
 
-static auto NormalizeToDefaultDelimeter(
-    std::string s,
-    const std::string& default_delim,
-    const std::vector<std::string>& delimeters) {
-  for (const auto& delimeter : delimeters) {
-    s = ReplaceAll(s, delimeter, default_delim);
+// First token that begins at pos or after it. Bytes that are not part of any
+// delimiter, or '\n', can not be inside a matched delimiter, so scanning
+// from the byte after them finds the same delimiters as scanning from the
+// beginning of numbers.
+static size_t NextTokenBegin(std::string_view numbers,
+                             size_t pos,
+                             const DelimiterSet& delimiters) {
+  while (pos < numbers.size() && delimiters.Contains(numbers[pos]) &&
+         numbers[pos] != '\n') {
+    ++pos;
   }
-  return s;
-}
-
-static auto RemoveTagsFromDelimiters(std::string delimiters) {
-  delimiters.erase(0, 2);
-  delimiters.erase(delimiters.size() - 1);
-  if (delimiters.at(0) == '[') {
-    delimiters.erase(0, 1);
-  }
-  if (delimiters.at(delimiters.size() - 1) == ']') {
-    delimiters.erase(delimiters.size() - 1);
-  }
-  return delimiters;
-}
-
-static auto CutOffDelimiters(std::string* s) {
-  assert(s);
-  std::vector<std::string> delimiter{{','}};
-  if (s->size() > 2 && s->at(0) == '/' && s->at(1) == '/') {
-    auto new_line = std::find(std::begin(*s), std::end(*s), '\n');
-    if (new_line != std::end(*s)) {
-      std::string clean_delimiters(std::begin(*s), new_line + 1);
-      s->erase(0, clean_delimiters.size());
-      return SplitByDelim(RemoveTagsFromDelimiters(clean_delimiters), "][");
+  for (++pos; pos < numbers.size(); ++pos) {
+    const auto length = delimiters.MatchLength(numbers.substr(pos));
+    if (length != 0) {
+      return pos + length;
     }
   }
-
-  return delimiter;
-}
-
-static auto NorlmalizedSplit(std::string s) {
-  const auto delims = CutOffDelimiters(&s);
-  static const auto kDefaultDelim = '\n';
-  return SplitByDelim(NormalizeToDefaultDelimeter(s, {kDefaultDelim}, delims),
-                      {kDefaultDelim});
+  return numbers.size();
 }
 
-static auto ToIntNumbers(const std::vector<std::string>& numbers) {
-  std::vector<int> int_numbers(numbers.size());
-  static const auto kStringToInt = [](const std::string& s) {
-    return std::stoi(s);
-  };
-  transform(std::begin(numbers), std::end(numbers), std::begin(int_numbers),
-            kStringToInt);
-  return int_numbers;
+static auto SplitAtTokenBoundaries(std::string_view numbers,
+                                   size_t chunks,
+                                   const DelimiterSet& delimiters) {
+  std::vector<std::string_view> parts;
+  size_t begin = 0;
+  for (size_t chunk = 1; chunk <= chunks && begin < numbers.size(); ++chunk) {
+    const auto end =
+        chunk == chunks
+            ? numbers.size()
+            : NextTokenBegin(numbers,
+                             std::max(begin, numbers.size() / chunks * chunk),
+                             delimiters);
+    parts.push_back(numbers.substr(begin, end - begin));
+    begin = end;
+  }
+  return parts;
 }
 
-static auto CollectNegativeNumbers(const std::vector<int>& numbers) {
-  std::vector<int> invalid_numbers;
-  static const auto kLessThanZero = [](int value) { return value < 0; };
-  std::copy_if(std::begin(numbers), std::end(numbers),
-               std::back_inserter(invalid_numbers), kLessThanZero);
-  return invalid_numbers;
+int StringCalculator::Add(std::string_view numbers) {
+  const auto result = TryAdd(numbers);
+  ReportError(result);
+  return result.sum;
 }
 
-static auto MessageAboutNegativeNumbers(
-    const std::vector<int> negative_numbers) {
-  std::string message = "negatives not allowed: ";
-  for (const auto number : negative_numbers) {
-    message += std::to_string(number) + ' ';
-  }
-  return message;
+int StringCalculator::Add(std::string_view numbers,
+                          const DelimiterSet& delimiters) {
+  const auto result = TryAdd(numbers, delimiters);
+  ReportError(result);
+  return result.sum;
 }
 
-static void ReportErrorAboutNegativeNumbers(
-    const std::vector<int>& negative_numbers) {
-  if (!negative_numbers.empty()) {
-    throw std::logic_error(MessageAboutNegativeNumbers(negative_numbers));
+AddResult StringCalculator::TryAdd(std::string_view numbers) {
+  const auto header = CutOffDelimiters(&numbers);
+  AddResult result;
+  if (header.empty()) {
+    ParseNumbers(numbers, &result);
+  } else if (DelimiterSet::HasDelimiters(header)) {
+    ParseNumbers(numbers, DelimiterSet(header), &result);
+    result.ShiftPositions(0, header.size());
+  } else {
+    result.error = AddError::kInvalidHeader;
   }
+  result.Finish();
+  return result;
 }
 
-static void ReportErrorIfFoundNegativeNumbers(const std::vector<int>& numbers) {
-  ReportErrorAboutNegativeNumbers(CollectNegativeNumbers(numbers));
+AddResult StringCalculator::TryAdd(std::string_view numbers,
+                                   const DelimiterSet& delimiters) {
+  AddResult result;
+  ParseNumbers(numbers, delimiters, &result);
+  result.Finish();
+  return result;
 }
 
-static auto WithoutGraterThanThousandElements(std::vector<int> numbers) {
-  static const auto kGreater = [](int value) { return value > 1000; };
-  numbers.erase(
-      std::remove_if(std::begin(numbers), std::end(numbers), kGreater),
-      std::end(numbers));
-  return numbers;
-}
+int StringCalculator::ParallelAdd(std::string_view numbers,
+                                  WorkStealingPool* pool) {
+  assert(pool);
+  const auto header = CutOffDelimiters(&numbers);
+  const auto delimiters =
+      header.empty() ? DelimiterSet() : DelimiterSet(header);
+  const auto threads =
+      std::min(pool->Threads(), numbers.size() / kMinBytesPerThread);
+  if (threads <= 1) {
+    return Add(numbers, delimiters);
+  }
 
-static auto SplitToSmallIntNumbers(const std::string& numbers) {
-  return WithoutGraterThanThousandElements(
-      ToIntNumbers(NorlmalizedSplit(numbers)));
-}
+  const auto parts = SplitAtTokenBoundaries(
+      numbers, threads * kChunksPerThread, delimiters);
+  std::vector<AddResult> parsed_parts(parts.size());
+  std::vector<std::exception_ptr> allocation_errors(parts.size());
+  pool->Run(parts.size(), [&](size_t part) {
+    try {
+      ParseNumbers(parts[part], delimiters, &parsed_parts[part]);
+    } catch (...) {
+      allocation_errors[part] = std::current_exception();
+    }
+  });
 
-int StringCalculator::Add(const std::string& numbers) {
-  auto small_numbers = SplitToSmallIntNumbers(numbers);
-  ReportErrorIfFoundNegativeNumbers(small_numbers);
-  return std::accumulate(std::begin(small_numbers), std::end(small_numbers), 0);
+  // First error of the first failed part is the first error of numbers.
+  AddResult parsed;
+  for (size_t part = 0; part < parts.size() && parsed.Ok(); ++part) {
+    if (allocation_errors[part]) {
+      std::rethrow_exception(allocation_errors[part]);
+    }
+    const auto first_negative = parsed.negative_numbers.size();
+    parsed.error = parsed_parts[part].error;
+    parsed.sum += parsed_parts[part].sum;
+    parsed.negative_numbers.insert(
+        std::end(parsed.negative_numbers),
+        std::begin(parsed_parts[part].negative_numbers),
+        std::end(parsed_parts[part].negative_numbers));
+    parsed.ShiftPositions(
+        first_negative,
+        header.size() + static_cast<size_t>(parts[part].data() -
+                                            numbers.data()));
+  }
+  parsed.Finish();
+  ReportError(parsed);
+  return parsed.sum;
 }
@@ -1,6 +1,26 @@
-#include <string>
+#pragma once
+
+#include <string_view>
+
+#include <add_result.h>
+#include <delimiter_set.h>
+
+class WorkStealingPool;
 
 class StringCalculator {
  public:
-  static int Add(const std::string& numbers);
+  // Throws what TryAdd reports, see AddError.
+  static int Add(std::string_view numbers);
+  // Numbers without header, split by already parsed delimiters.
+  static int Add(std::string_view numbers, const DelimiterSet& delimiters);
+  // Add that reports errors in result instead of throwing. Nothing is
+  // allocated unless there are negatives, message is built only by
+  // AddResult::Message.
+  static AddResult TryAdd(std::string_view numbers);
+  static AddResult TryAdd(std::string_view numbers,
+                          const DelimiterSet& delimiters);
+  // Add on threads of pool, which is reused by every call. Numbers are split
+  // into chunks at token boundaries, so results and errors are the same as
+  // of Add. Small numbers are added on the calling thread only.
+  static int ParallelAdd(std::string_view numbers, WorkStealingPool* pool);
 };
@@ -0,0 +1,125 @@
+#include <work_stealing_pool.h>
+
+#include <algorithm>
+#include <cassert>
+
+static uint64_t Pack(uint64_t begin, uint64_t end) {
+  return begin << 32 | end;
+}
+
+static bool TakeFront(std::atomic<uint64_t>* range, size_t* task) {
+  auto packed = range->load(std::memory_order_relaxed);
+  for (;;) {
+    const auto begin = packed >> 32;
+    const auto end = packed & 0xffffffffu;
+    if (begin >= end) {
+      return false;
+    }
+    if (range->compare_exchange_weak(packed, Pack(begin + 1, end))) {
+      *task = begin;
+      return true;
+    }
+  }
+}
+
+static bool TakeBack(std::atomic<uint64_t>* range, size_t* task) {
+  auto packed = range->load(std::memory_order_relaxed);
+  for (;;) {
+    const auto begin = packed >> 32;
+    const auto end = packed & 0xffffffffu;
+    if (begin >= end) {
+      return false;
+    }
+    if (range->compare_exchange_weak(packed, Pack(begin, end - 1))) {
+      *task = end - 1;
+      return true;
+    }
+  }
+}
+
+WorkStealingPool::WorkStealingPool(size_t threads)
+    : queues_(std::max(threads, size_t{1})),
+      threads_(),
+      mutex_(),
+      wake_(),
+      done_(),
+      task_(nullptr),
+      generation_(0),
+      busy_threads_(0),
+      stop_(false) {
+  for (size_t queue = 1; queue < queues_.size(); ++queue) {
+    threads_.emplace_back([this, queue] { Work(queue); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::Run(size_t tasks,
+                           const std::function<void(size_t)>& task) {
+  assert(tasks <= 0xffffffffu);
+  const auto queues = queues_.size();
+  for (size_t queue = 0; queue < queues; ++queue) {
+    queues_[queue].range.store(
+        Pack(queue * tasks / queues, (queue + 1) * tasks / queues),
+        std::memory_order_relaxed);
+  }
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    ++generation_;
+    busy_threads_ = threads_.size();
+  }
+  wake_.notify_all();
+
+  RunTasks(0, task);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_threads_ == 0; });
+  task_ = nullptr;
+}
+
+void WorkStealingPool::Work(size_t queue) {
+  uint64_t generation = 0;
+  for (;;) {
+    const std::function<void(size_t)>* task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&] { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      task = task_;
+    }
+
+    RunTasks(queue, *task);
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (--busy_threads_ == 0) {
+      done_.notify_one();
+    }
+  }
+}
+
+void WorkStealingPool::RunTasks(size_t queue,
+                                const std::function<void(size_t)>& task) {
+  size_t index = 0;
+  while (TakeFront(&queues_[queue].range, &index)) {
+    task(index);
+  }
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    auto& victim = queues_[(queue + i) % queues_.size()];
+    while (TakeBack(&victim.range, &index)) {
+      task(index);
+    }
+  }
+}
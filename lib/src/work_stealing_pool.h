@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads running batches of indexed tasks. Each thread starts
+// with its own contiguous share of task indices and steals from the back of
+// other shares once its own is done.
+class WorkStealingPool {
+ public:
+  // Number of threads includes the one calling Run.
+  explicit WorkStealingPool(size_t threads);
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+  ~WorkStealingPool();
+
+  size_t Threads() const { return queues_.size(); }
+
+  // Calls task(i) for every i in [0, tasks) and returns when all are done.
+  // Task must not throw.
+  void Run(size_t tasks, const std::function<void(size_t)>& task);
+
+ private:
+  // Range of task indices packed into one word, so that owner taking from the
+  // front and thieves taking from the back need a single CAS each.
+  struct alignas(64) Queue {
+    std::atomic<uint64_t> range{0};
+  };
+
+  void Work(size_t queue);
+  void RunTasks(size_t queue, const std::function<void(size_t)>& task);
+
+  std::vector<Queue> queues_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* task_;
+  uint64_t generation_;
+  size_t busy_threads_;
+  bool stop_;
+};
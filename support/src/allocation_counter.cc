@@ -0,0 +1,26 @@
+#include <allocation_counter.h>
+
+#include <cstdlib>
+#include <new>
+
+static thread_local size_t allocation_count = 0;
+
+size_t AllocationCount() {
+  return allocation_count;
+}
+
+void* operator new(size_t size) {
+  ++allocation_count;
+  if (auto memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  std::free(memory);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+
+// Number of global operator new calls made by the current thread so far.
+size_t AllocationCount();
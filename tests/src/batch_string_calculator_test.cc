@@ -0,0 +1,88 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <doctest.h>
+
+#include <allocation_counter.h>
+#include <batch_string_calculator.h>
+#include <string_calculator.h>
+
+SCENARIO("BatchStringCalculator adds every input of a batch") {
+  BatchStringCalculator calculator;
+
+  GIVEN("inputs with valid numbers") {
+    const std::vector<std::string_view> inputs{
+        "", "1,2,3", "1\n2,3", "//;\n1;2", "//[***][xx][z]\n1***2xx3",
+        "2,1001"};
+    std::vector<BatchResult> results(inputs.size());
+
+    WHEN("add them in a batch") {
+      calculator.AddBatch(inputs.data(), results.data(), inputs.size());
+
+      THEN("every result is the same as of Add") {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+          REQUIRE(results[i].error == AddError::kNone);
+          REQUIRE_EQ(results[i].sum, StringCalculator::Add(inputs[i]));
+        }
+      }
+    }
+  }
+
+  GIVEN("inputs with errors between valid ones") {
+    const std::vector<std::string_view> inputs{
+        "1,-5,4,-3", "1,2", "1,,2", "1,2147483648", "//\n1", "//;\n-1;-2"};
+    std::vector<BatchResult> results(inputs.size());
+
+    WHEN("add them in a batch") {
+      calculator.AddBatch(inputs.data(), results.data(), inputs.size());
+
+      THEN("each error is reported for its own input") {
+        REQUIRE(results[0].error == AddError::kNegativeNumbers);
+        REQUIRE_EQ(results[0].negatives_count, 2);
+        REQUIRE_EQ(calculator.Negatives(results[0])[0].value, -5);
+        REQUIRE_EQ(calculator.Negatives(results[0])[1].value, -3);
+        REQUIRE_EQ(calculator.Negatives(results[0])[1].position, 7);
+        REQUIRE_EQ(calculator.Negatives(results[5])[1].position, 7);
+        REQUIRE(results[1].error == AddError::kNone);
+        REQUIRE_EQ(results[1].sum, 3);
+        REQUIRE(results[2].error == AddError::kInvalidNumber);
+        REQUIRE(results[3].error == AddError::kNumberOutOfRange);
+        REQUIRE(results[4].error == AddError::kInvalidHeader);
+        REQUIRE(results[5].error == AddError::kNegativeNumbers);
+      }
+
+      THEN("negatives message is the same as thrown by Add") {
+        REQUIRE_EQ(calculator.ErrorMessage(results[0]),
+                   "negatives not allowed: -5 -3 ");
+        REQUIRE_EQ(calculator.ErrorMessage(results[5]),
+                   "negatives not allowed: -1 -2 ");
+        REQUIRE(calculator.ErrorMessage(results[1]).empty());
+      }
+    }
+  }
+
+  GIVEN("batch of short inputs added once") {
+    std::vector<std::string_view> inputs;
+    for (auto i = 0; i < 100; ++i) {
+      inputs.insert(std::end(inputs),
+                    {"1,2,3", "//[***][xx]\n1***2xx3", "//;\n4;5", "1,-2,-3"});
+    }
+    std::vector<BatchResult> results(inputs.size());
+    const auto first_allocations = AllocationCount();
+    calculator.AddBatch(inputs.data(), results.data(), inputs.size());
+    REQUIRE_NE(AllocationCount(), first_allocations);  // Headers, negatives.
+
+    WHEN("add same batch again") {
+      const auto allocations = AllocationCount();
+      calculator.AddBatch(inputs.data(), results.data(), inputs.size());
+      const auto batch_allocations = AllocationCount() - allocations;
+
+      THEN("nothing is allocated") {
+        REQUIRE_EQ(batch_allocations, 0);
+        REQUIRE_EQ(results[1].sum, 6);
+        REQUIRE(results[3].error == AddError::kNegativeNumbers);
+      }
+    }
+  }
+}
@@ -0,0 +1,216 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include <caching_string_calculator.h>
+#include <result_of.h>
+#include <sharded_cache.h>
+#include <string_calculator.h>
+
+static const std::vector<std::string> kNumbers{
+    "",          "1,2",           "1\n2,3",     "1001,2",
+    "//;\n1;2",  "//[***]\n1***2", "//[*][%]\n1*2%3",
+    "1,-5,4,-3", "//;\n1;-2",     "1,,2",       "1,2147483648",
+    "//\n1",     "//[\n1",        "//]\n1",     "x"};
+
+SCENARIO("CachingStringCalculator adds as StringCalculator") {
+  GIVEN("calculator with default capacity") {
+    CachingStringCalculator calculator;
+
+    WHEN("add every input twice") {
+      THEN("results and exceptions are the same as without cache") {
+        for (auto round = 0; round < 2; ++round) {
+          for (const auto& numbers : kNumbers) {
+            const auto cached = [&] { return calculator.Add(numbers); };
+            const auto uncached = [&] {
+              return StringCalculator::Add(numbers);
+            };
+            REQUIRE_EQ(ResultOf(cached), ResultOf(uncached));
+          }
+        }
+      }
+
+      THEN("second round only hits") {
+        for (auto round = 0; round < 2; ++round) {
+          for (const auto& numbers : kNumbers) {
+            calculator.TryAdd(numbers);
+          }
+        }
+        const auto counters = calculator.ResultCounters();
+        REQUIRE_EQ(counters.hits, kNumbers.size());
+        REQUIRE_EQ(counters.misses, kNumbers.size());
+        REQUIRE_EQ(counters.evictions, 0);
+      }
+    }
+
+    WHEN("add numbers with negatives again") {
+      static const auto kNegativeNumbers = "//[***]\n1***-5***4\n-3";
+      calculator.TryAdd(kNegativeNumbers);
+      const auto result = calculator.TryAdd(kNegativeNumbers);
+
+      THEN("cached negatives and their positions are reported") {
+        REQUIRE_EQ(calculator.ResultCounters().hits, 1);
+        REQUIRE(result.error == AddError::kNegativeNumbers);
+        REQUIRE_EQ(result.negative_numbers.size(), 2);
+        REQUIRE_EQ(result.negative_numbers[0].position, 12);
+        REQUIRE_EQ(result.negative_numbers[1].position, 19);
+        REQUIRE_EQ(ResultOf([&] { return calculator.Add(kNegativeNumbers); }),
+                   ResultOf([] {
+                     return StringCalculator::Add(kNegativeNumbers);
+                   }));
+      }
+    }
+
+    WHEN("add different numbers with the same header") {
+      calculator.Add("//[***][%]\n1***2");
+      calculator.Add("//[***][%]\n3%4");
+      calculator.Add("//[***][%]\n5\n6");
+
+      THEN("header is parsed once") {
+        const auto counters = calculator.HeaderCounters();
+        REQUIRE_EQ(counters.misses, 1);
+        REQUIRE_EQ(counters.hits, 2);
+      }
+    }
+
+    WHEN("add numbers longer than cached ones twice") {
+      const auto numbers = std::string(
+          CachingStringCalculator::kMaxCachedSize + 1, '1');
+      REQUIRE_EQ(ResultOf([&] { return calculator.Add(numbers); }),
+                 ResultOf([&] { return StringCalculator::Add(numbers); }));
+      calculator.TryAdd(numbers);
+
+      THEN("they are neither cached nor counted") {
+        REQUIRE_EQ(calculator.ResultCounters().hits, 0);
+        REQUIRE_EQ(calculator.ResultCounters().misses, 0);
+      }
+    }
+  }
+
+  GIVEN("calculator with small capacity") {
+    CachingStringCalculator calculator(ShardedCache<AddResult>::kShards, 0);
+
+    WHEN("add more different inputs than it holds twice") {
+      for (auto round = 0; round < 2; ++round) {
+        for (auto i = 0; i < 100; ++i) {
+          REQUIRE_EQ(calculator.Add(std::to_string(i) + ",1"), i + 1);
+        }
+      }
+
+      THEN("old results are evicted") {
+        const auto counters = calculator.ResultCounters();
+        REQUIRE_EQ(counters.hits + counters.misses, 200);
+        REQUIRE(counters.misses > 100);
+        REQUIRE(counters.evictions + ShardedCache<AddResult>::kShards >=
+                counters.misses);
+        REQUIRE_EQ(calculator.HeaderCounters().hits, 0);
+      }
+    }
+  }
+
+  GIVEN("calculator with capacity of one result") {
+    CachingStringCalculator calculator(1, 0);
+
+    WHEN("add many different inputs twice") {
+      for (auto round = 0; round < 2; ++round) {
+        for (auto i = 0; i < 400; ++i) {
+          calculator.TryAdd(std::to_string(i) + ",1");
+        }
+      }
+
+      THEN("at most one result is kept") {
+        const auto counters = calculator.ResultCounters();
+        REQUIRE_EQ(counters.hits + counters.misses, 800);
+        REQUIRE(counters.hits <= 1);
+      }
+    }
+  }
+
+  GIVEN("calculator shared by threads") {
+    CachingStringCalculator calculator(64);
+
+    WHEN("threads add the same inputs") {
+      std::vector<std::string> results(4);
+      std::vector<std::thread> threads;
+      for (auto& result : results) {
+        threads.emplace_back([&] {
+          for (auto i = 0; i < 1000; ++i) {
+            const auto& numbers = kNumbers[static_cast<size_t>(i) %
+                                           kNumbers.size()];
+            result += ResultOf([&] { return calculator.Add(numbers); });
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      THEN("every thread gets results of StringCalculator") {
+        std::string expected;
+        for (auto i = 0; i < 1000; ++i) {
+          const auto& numbers = kNumbers[static_cast<size_t>(i) %
+                                         kNumbers.size()];
+          expected += ResultOf([&] { return StringCalculator::Add(numbers); });
+        }
+        for (const auto& result : results) {
+          REQUIRE_EQ(result, expected);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("ShardedCache compares keys") {
+  GIVEN("cache with a value") {
+    ShardedCache<int> cache(16);
+    cache.Insert(1, "one", 1);
+
+    WHEN("look up key with the same hash") {
+      THEN("only the same key is found") {
+        int value = 0;
+        REQUIRE(cache.Find(1, "one", &value));
+        REQUIRE_EQ(value, 1);
+        REQUIRE_FALSE(cache.Find(1, "two", &value));
+        REQUIRE_FALSE(cache.Find(2, "one", &value));
+      }
+    }
+
+    WHEN("insert other key with the same hash") {
+      cache.Insert(1, "two", 2);
+
+      THEN("it replaces the value") {
+        int value = 0;
+        REQUIRE(cache.Find(1, "two", &value));
+        REQUIRE_EQ(value, 2);
+        REQUIRE_FALSE(cache.Find(1, "one", &value));
+        REQUIRE_EQ(cache.Counters().evictions, 1);
+      }
+    }
+  }
+
+  GIVEN("cache with less capacity than shards") {
+    ShardedCache<int> cache(3);
+
+    WHEN("insert a key into every shard") {
+      const auto hash_of = [](size_t shard) {
+        return uint64_t{shard} << (64 - ShardedCache<int>::kShardBits);
+      };
+      for (size_t shard = 0; shard < ShardedCache<int>::kShards; ++shard) {
+        cache.Insert(hash_of(shard), std::to_string(shard), 1);
+      }
+
+      THEN("only as many keys as the capacity are kept") {
+        size_t kept = 0;
+        for (size_t shard = 0; shard < ShardedCache<int>::kShards; ++shard) {
+          int value = 0;
+          kept += cache.Find(hash_of(shard), std::to_string(shard), &value);
+        }
+        REQUIRE_EQ(kept, 3);
+      }
+    }
+  }
+}
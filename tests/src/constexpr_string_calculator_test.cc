@@ -0,0 +1,128 @@
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <doctest.h>
+
+#include <constexpr_string_calculator.h>
+#include <result_of.h>
+
+// Whether Add of Input::kNumbers is a constant expression. Numbers Add
+// throws for are not, which makes them compile errors in constants.
+template <typename Input,
+          int = (ConstexprStringCalculator::Add(Input::kNumbers), 0)>
+constexpr bool IsConstant(int) {
+  return true;
+}
+
+template <typename Input>
+constexpr bool IsConstant(...) {
+  return false;
+}
+
+#define CONSTANT_INPUT(name, numbers)                     \
+  struct name {                                           \
+    static constexpr std::string_view kNumbers = numbers; \
+  }
+
+// Every scenario of string_calculator_test.cc, folded at compile time.
+static_assert(ConstexprStringCalculator::Add("") == 0, "empty string");
+static_assert(ConstexprStringCalculator::Add("1") == 1, "single number");
+static_assert(ConstexprStringCalculator::Add("1,2") == 3, "two numbers");
+static_assert(ConstexprStringCalculator::Add("22,0,1,5,11") == 39,
+              "some number of numbers");
+static_assert(ConstexprStringCalculator::Add("1\n2,3") == 6,
+              "\\n as separator");
+static_assert(ConstexprStringCalculator::Add("//;\n1;2") == 3,
+              "custom delimiter");
+static_assert(ConstexprStringCalculator::Add("//*\n1*2\n5") == 8,
+              "custom delimiter and \\n");
+CONSTANT_INPUT(PositiveNumber, "5");
+static_assert(IsConstant<PositiveNumber>(0), "positive number");
+CONSTANT_INPUT(SingleNegativeNumber, "-5");
+static_assert(!IsConstant<SingleNegativeNumber>(0), "negative number");
+CONSTANT_INPUT(MultipleNegativeNumbers, "1,-5,4,-3,6,-1");
+static_assert(!IsConstant<MultipleNegativeNumbers>(0),
+              "multiple negative numbers");
+static_assert(ConstexprStringCalculator::Add("2,1001") == 2,
+              "number bigger than 1000");
+static_assert(ConstexprStringCalculator::Add("//[***]\n1***2***3") == 6,
+              "delimiter of any length");
+static_assert(ConstexprStringCalculator::Add("//[*][x][z]\n1*2x3") == 6,
+              "multiple delimiters");
+static_assert(ConstexprStringCalculator::Add("//[***][xx][z]\n1***2xx3") == 6,
+              "multichar multiple delimiters");
+static_assert(ConstexprStringCalculator::Add(std::string_view("1,2,3,4", 3)) ==
+                  3,
+              "string view on part of larger buffer");
+static_assert(ConstexprStringCalculator::Add("1,2,") == 3,
+              "trailing delimiter");
+CONSTANT_INPUT(EmptyNumber, "1,,2");
+static_assert(!IsConstant<EmptyNumber>(0), "two delimiters in a row");
+CONSTANT_INPUT(HugeNumber, "1,2147483648");
+static_assert(!IsConstant<HugeNumber>(0), "number that does not fit into int");
+
+// Delimiters known at compile time.
+static constexpr char kMultiCharHeader[] = "//[***][xx][z]\n";
+static constexpr char kOverlappingHeader[] = "//[ab][abc][b]\n";
+static_assert(StringCalculatorFor<kMultiCharHeader>::Add("1***2xx3\n4z5") ==
+                  15,
+              "compile time delimiters");
+static_assert(StringCalculatorFor<kOverlappingHeader>::Add("1abc2ab3b4") == 10,
+              "longest delimiter is matched first");
+static_assert(ConstexprStringCalculator::Add("//[2][23]\n4231") == 5,
+              "longest delimiter is matched first with header");
+static_assert(ConstexprStringCalculator::Add("//]\n1\n2") == 3,
+              "header with no delimiters");
+CONSTANT_INPUT(EmptyHeader, "//[\n1");
+static_assert(!IsConstant<EmptyHeader>(0), "empty delimiters header");
+
+SCENARIO("ConstexprStringCalculator adds numbers known at run time") {
+  GIVEN("numbers Add throws for") {
+    static const auto kNumbers = {"1,-5,4,-3,6,-1", "1,,2", "1,2147483648",
+                                  "//\n1", "//[\n1"};
+
+    THEN("the same exceptions are thrown") {
+      for (const std::string_view numbers : kNumbers) {
+        REQUIRE_EQ(
+            ResultOf([&] { return ConstexprStringCalculator::Add(numbers); }),
+            ResultOf([&] { return StringCalculator::Add(numbers); }));
+      }
+      REQUIRE_THROWS_AS(StringCalculatorFor<kMultiCharHeader>::Add("1***-2"),
+                        const std::logic_error&);
+    }
+  }
+
+  GIVEN("header with more delimiters than fit into ConstexprDelimiterSet") {
+    std::string numbers = "//";
+    for (auto i = 0; i < 20; ++i) {
+      numbers += '[' + std::string(1, static_cast<char>('a' + i)) + ']';
+    }
+    numbers += "\n1a2b3t4";
+
+    THEN("numbers are added at run time") {
+      REQUIRE_EQ(ConstexprStringCalculator::Add(numbers), 10);
+    }
+  }
+
+  GIVEN("randomized numbers") {
+    std::mt19937 random(2017);
+    static const std::string kHeaders[] = {"", "//;\n", "//[***][xx][z]\n",
+                                           "//[ab][abc][b]\n", "//]\n"};
+    static const std::string kAlphabet = "0123456789012345,\n-*xzab; ";
+
+    THEN("results are the same as of StringCalculator") {
+      for (auto i = 0; i < 20000; ++i) {
+        auto numbers = kHeaders[random() % 5];
+        const auto size = random() % 30;
+        for (size_t j = 0; j < size; ++j) {
+          numbers += kAlphabet[random() % kAlphabet.size()];
+        }
+        REQUIRE_EQ(
+            ResultOf([&] { return ConstexprStringCalculator::Add(numbers); }),
+            ResultOf([&] { return StringCalculator::Add(numbers); }));
+      }
+    }
+  }
+}
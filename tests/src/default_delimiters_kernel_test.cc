@@ -0,0 +1,103 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <doctest.h>
+
+#include <default_delimiters_kernel.h>
+
+static std::string Parse(const std::string& numbers,
+                         InstructionSet instruction_set) {
+  AddResult parsed;
+  ParseNumbers(numbers, instruction_set, &parsed);
+  if (!parsed.Ok()) {
+    return "error " + std::to_string(static_cast<int>(parsed.error));
+  }
+  auto result = std::to_string(parsed.sum) + " negatives:";
+  for (const auto& number : parsed.negative_numbers) {
+    result += ' ' + std::to_string(number.value) + " at " +
+              std::to_string(number.position);
+  }
+  return result;
+}
+
+static auto SupportedInstructionSets() {
+  std::vector<InstructionSet> instruction_sets{InstructionSet::kScalar};
+  const auto supported = SupportedInstructionSet();
+  if (supported == InstructionSet::kSse42 ||
+      supported == InstructionSet::kAvx2) {
+    instruction_sets.push_back(InstructionSet::kSse42);
+  }
+  if (supported == InstructionSet::kAvx2) {
+    instruction_sets.push_back(InstructionSet::kAvx2);
+  }
+  return instruction_sets;
+}
+
+static auto RandomNumbers(std::mt19937* random, const std::string& alphabet) {
+  std::string numbers;
+  const auto size = (*random)() % 200;
+  while (numbers.size() < size) {
+    const auto kind = (*random)() % 8;
+    if (kind < 5) {
+      numbers += std::to_string((*random)() % 2000);
+    } else if (kind == 5) {
+      numbers += std::to_string(static_cast<int>((*random)()));
+    } else {
+      numbers += alphabet[(*random)() % alphabet.size()];
+    }
+    numbers += (*random)() % 2 ? ',' : '\n';
+  }
+  if (!numbers.empty() && (*random)() % 2) {
+    numbers.pop_back();
+  }
+  return numbers;
+}
+
+SCENARIO("Vector kernels parse numbers same way as scalar code") {
+  GIVEN("numbers from StringCalculator scenarios") {
+    static const std::vector<std::string> kNumbers{
+        "", "1", "1,2", "22,0,1,5,11", "1\n2,3", "-5", "1,-5,4,-3,6,-1",
+        "2,1001", "1,2,", "1,,2", "1,2147483648"};
+
+    THEN("every kernel gives the same result") {
+      for (const auto instruction_set : SupportedInstructionSets()) {
+        for (const auto& numbers : kNumbers) {
+          REQUIRE_EQ(Parse(numbers, instruction_set),
+                     Parse(numbers, InstructionSet::kScalar));
+        }
+      }
+    }
+  }
+
+  GIVEN("long numbers with small, big and negative numbers") {
+    std::string numbers;
+    for (auto i = -1500; i < 1500; i += 7) {
+      numbers += std::to_string(i) + (i % 2 ? '\n' : ',');
+    }
+
+    THEN("every kernel gives the same result") {
+      for (const auto instruction_set : SupportedInstructionSets()) {
+        REQUIRE_EQ(Parse(numbers, instruction_set),
+                   Parse(numbers, InstructionSet::kScalar));
+      }
+    }
+  }
+
+  GIVEN("randomized numbers") {
+    std::mt19937 random(2017);
+    static const std::string kValid = "0123456789";
+    static const std::string kUnusual = "0123456789-+ \t*x,\n";
+
+    THEN("every kernel gives the same result") {
+      for (const auto instruction_set : SupportedInstructionSets()) {
+        for (auto i = 0; i < 20000; ++i) {
+          const auto numbers =
+              RandomNumbers(&random, i % 2 ? kValid : kUnusual);
+          REQUIRE_EQ(Parse(numbers, instruction_set),
+                     Parse(numbers, InstructionSet::kScalar));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#include <stdexcept>
+#include <string>
+
+#include <doctest.h>
+
+#include <delimiter_set.h>
+#include <string_calculator.h>
+
+SCENARIO("DelimiterSet matches delimiters from header") {
+  GIVEN("default delimiter set") {
+    const DelimiterSet delimiters;
+
+    THEN("it is default and matches comma and new line") {
+      REQUIRE(delimiters.IsDefault());
+      REQUIRE_EQ(delimiters.MatchLength(",1"), 1);
+      REQUIRE_EQ(delimiters.MatchLength("\n1"), 1);
+      REQUIRE_EQ(delimiters.MatchLength("1,"), 0);
+    }
+  }
+
+  GIVEN("numbers with header") {
+    static const auto kNumbers = "//[***][xx][z]\n1***2xx3";
+
+    WHEN("take header of that numbers") {
+      const auto header = DelimiterSet::HeaderOf(kNumbers);
+
+      THEN("header ends with new line") {
+        REQUIRE_EQ(header, "//[***][xx][z]\n");
+      }
+    }
+  }
+
+  GIVEN("numbers without header") {
+    THEN("header is empty") {
+      REQUIRE(DelimiterSet::HeaderOf("1,2").empty());
+      REQUIRE(DelimiterSet::HeaderOf("//;1;2").empty());
+    }
+  }
+
+  GIVEN("set built from header with multichar delimiters") {
+    const DelimiterSet delimiters("//[***][xx][z]\n");
+
+    THEN("every delimiter and new line are matched") {
+      REQUIRE_FALSE(delimiters.IsDefault());
+      REQUIRE_EQ(delimiters.MatchLength("***1"), 3);
+      REQUIRE_EQ(delimiters.MatchLength("xx1"), 2);
+      REQUIRE_EQ(delimiters.MatchLength("z1"), 1);
+      REQUIRE_EQ(delimiters.MatchLength("\n1"), 1);
+    }
+
+    THEN("comma and partial delimiters are not matched") {
+      REQUIRE_EQ(delimiters.MatchLength(",1"), 0);
+      REQUIRE_EQ(delimiters.MatchLength("**1"), 0);
+      REQUIRE_EQ(delimiters.MatchLength("x1"), 0);
+    }
+
+    WHEN("reuse it for several numbers") {
+      THEN("each sum is calculated with same delimiters") {
+        REQUIRE_EQ(StringCalculator::Add("1***2xx3", delimiters), 6);
+        REQUIRE_EQ(StringCalculator::Add("4z5\n6", delimiters), 15);
+        REQUIRE_EQ(StringCalculator::Add("", delimiters), 0);
+      }
+    }
+  }
+
+  GIVEN("overlapping delimiters where one is prefix of another") {
+    const DelimiterSet short_first("//[x][xx]\n");
+    const DelimiterSet long_first("//[xx][x]\n");
+
+    THEN("longest delimiter wins regardless of header order") {
+      REQUIRE_EQ(short_first.MatchLength("xx1"), 2);
+      REQUIRE_EQ(long_first.MatchLength("xx1"), 2);
+      REQUIRE_EQ(StringCalculator::Add("1xx2x3", short_first), 6);
+      REQUIRE_EQ(StringCalculator::Add("1xx2x3", long_first), 6);
+    }
+
+    THEN("longest match is taken greedily from left to right") {
+      REQUIRE_THROWS_AS(StringCalculator::Add("1xxx2", short_first),
+                        const std::invalid_argument&);
+    }
+  }
+
+  GIVEN("overlapping delimiters sharing a middle part") {
+    const DelimiterSet delimiters("//[ab][bc]\n");
+
+    THEN("leftmost delimiter is matched first") {
+      REQUIRE_EQ(StringCalculator::Add("1ab2bc3", delimiters), 6);
+      REQUIRE_THROWS_AS(StringCalculator::Add("1abc2", delimiters),
+                        const std::invalid_argument&);
+    }
+  }
+
+  GIVEN("delimiter made of digits") {
+    const DelimiterSet delimiters("//[1]\n");
+
+    THEN("digits of delimiter separate numbers") {
+      REQUIRE_EQ(StringCalculator::Add("213", delimiters), 5);
+    }
+  }
+
+  GIVEN("header without delimiters inside") {
+    THEN("set can not be built") {
+      REQUIRE_THROWS_AS(DelimiterSet("//\n"), const std::out_of_range&);
+      REQUIRE_THROWS_AS(DelimiterSet("1,2"), const std::invalid_argument&);
+    }
+  }
+}
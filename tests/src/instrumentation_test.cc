@@ -0,0 +1,146 @@
+#include <stdexcept>
+#include <string>
+
+#include <doctest.h>
+
+#include <instrumentation.h>
+#include <string_calculator.h>
+#include <work_stealing_pool.h>
+
+static InstrumentationSnapshot Difference(
+    const InstrumentationSnapshot& before,
+    const InstrumentationSnapshot& after) {
+  InstrumentationSnapshot difference;
+  for (size_t stage = 0; stage < kPipelineStages; ++stage) {
+    difference.stages[stage].calls =
+        after.stages[stage].calls - before.stages[stage].calls;
+    difference.stages[stage].cycles =
+        after.stages[stage].cycles - before.stages[stage].cycles;
+    difference.stages[stage].bytes =
+        after.stages[stage].bytes - before.stages[stage].bytes;
+  }
+  for (size_t counter = 0; counter < kPipelineCounters; ++counter) {
+    difference.counters[counter] =
+        after.counters[counter] - before.counters[counter];
+  }
+  return difference;
+}
+
+static const StageCounters& Of(const InstrumentationSnapshot& snapshot,
+                               PipelineStage stage) {
+  return snapshot.stages[static_cast<size_t>(stage)];
+}
+
+static uint64_t Of(const InstrumentationSnapshot& snapshot,
+                   PipelineCounter counter) {
+  return snapshot.counters[static_cast<size_t>(counter)];
+}
+
+static void AddIgnoringErrors(const std::string& numbers) {
+  try {
+    StringCalculator::Add(numbers);
+  } catch (const std::exception&) {
+  }
+}
+
+SCENARIO("Add pipeline is instrumented only when it is enabled") {
+  GIVEN("numbers that go through every stage") {
+    std::string long_numbers = "1";
+    for (auto i = 1; i < 1000; ++i) {
+      long_numbers += i % 2 ? ",1" : "\n1";
+    }
+
+    WHEN("add them") {
+      const auto before = TakeInstrumentationSnapshot();
+      REQUIRE_EQ(StringCalculator::Add("1,2,3"), 6);
+      AddIgnoringErrors("//[***]\n1***-2");
+      AddIgnoringErrors("1,,2");
+      REQUIRE_EQ(StringCalculator::Add(long_numbers), 1000);
+      const auto after = TakeInstrumentationSnapshot();
+      const auto difference = Difference(before, after);
+
+      THEN("every stage and event is counted if enabled, nothing otherwise") {
+        const auto enabled = InstrumentationEnabled() ? 1u : 0u;
+        REQUIRE_EQ(Of(difference, PipelineStage::kHeader).calls, enabled);
+        REQUIRE_EQ(Of(difference, PipelineStage::kHeader).bytes, enabled * 8);
+        REQUIRE_EQ(Of(difference, PipelineStage::kParse).calls, enabled * 4);
+        REQUIRE_EQ(Of(difference, PipelineStage::kParse).bytes,
+                   enabled * (5 + 6 + 4 + long_numbers.size()));
+        REQUIRE_EQ(Of(difference, PipelineStage::kReport).calls, enabled * 2);
+        REQUIRE_EQ(Of(difference, PipelineCounter::kTokens),
+                   enabled * (3 + 2 + 1 + 1000));
+        REQUIRE_EQ(Of(difference, PipelineCounter::kAllocations), enabled * 3);
+        REQUIRE_EQ(Of(difference, PipelineCounter::kExceptions), enabled * 2);
+        if (!InstrumentationEnabled()) {
+          REQUIRE_EQ(after.stages[0].cycles + after.stages[1].cycles +
+                         after.stages[2].cycles,
+                     0);
+        }
+      }
+    }
+  }
+
+  GIVEN("malformed numbers longer than a vector block") {
+    static const auto kNumbers = "1,2,x,4,5,6,7,8,9,1,2,3,4,5,6,7,8,9";
+
+    WHEN("add them") {
+      const auto before = TakeInstrumentationSnapshot();
+      AddIgnoringErrors(kNumbers);
+      const auto difference =
+          Difference(before, TakeInstrumentationSnapshot());
+
+      THEN("only tokens before the malformed one are counted") {
+        const auto enabled = InstrumentationEnabled() ? 1u : 0u;
+        REQUIRE_EQ(Of(difference, PipelineStage::kParse).bytes,
+                   enabled * std::string(kNumbers).size());
+        REQUIRE_EQ(Of(difference, PipelineCounter::kTokens), enabled * 2);
+        REQUIRE_EQ(Of(difference, PipelineCounter::kExceptions), enabled);
+      }
+    }
+  }
+
+  GIVEN("large numbers added on many threads") {
+    std::string numbers;
+    size_t repeats = 0;
+    for (; numbers.size() < (size_t{3} << 20); ++repeats) {
+      numbers += "1,22\n333,";
+    }
+
+    WHEN("add them in parallel") {
+      WorkStealingPool pool(3);
+      const auto before = TakeInstrumentationSnapshot();
+      const auto sum = StringCalculator::ParallelAdd(numbers, &pool);
+      const auto difference =
+          Difference(before, TakeInstrumentationSnapshot());
+
+      THEN("counters of pool threads are in the snapshot") {
+        REQUIRE_EQ(sum, 356 * static_cast<int>(repeats));
+        const auto enabled = InstrumentationEnabled() ? 1u : 0u;
+        REQUIRE_EQ(Of(difference, PipelineCounter::kTokens),
+                   enabled * repeats * 3);
+        REQUIRE_EQ(Of(difference, PipelineStage::kParse).bytes,
+                   enabled * numbers.size());
+      }
+    }
+  }
+
+  GIVEN("a snapshot") {
+    const auto snapshot = TakeInstrumentationSnapshot();
+
+    WHEN("dump it as Prometheus text") {
+      const auto text = PrometheusText(snapshot);
+
+      THEN("there is a sample for every stage and counter") {
+        REQUIRE_NE(text.find("string_calculator_stage_cycles_total{stage="
+                             "\"parse\"} " +
+                             std::to_string(snapshot.stages[1].cycles) +
+                             '\n'),
+                   std::string::npos);
+        REQUIRE_NE(text.find("# TYPE string_calculator_exceptions_total "
+                             "counter\nstring_calculator_exceptions_total " +
+                             std::to_string(snapshot.counters[2]) + '\n'),
+                   std::string::npos);
+      }
+    }
+  }
+}
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <doctest.h>
+
+#include <record_processor.h>
+#include <string_calculator.h>
+
+// Line the processor writes for numbers.
+static std::string LineOf(const std::string& numbers) {
+  try {
+    return std::to_string(StringCalculator::Add(numbers)) + '\n';
+  } catch (const std::exception& e) {
+    return std::string("error: ") + e.what() + '\n';
+  }
+}
+
+// Output of processor for records, processed count is set to what Process
+// returned.
+static std::string Process(RecordProcessor* processor,
+                           const std::vector<std::string>& numbers,
+                           size_t* processed) {
+  const std::vector<std::string_view> records(std::begin(numbers),
+                                              std::end(numbers));
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  std::string output;
+  try {
+    *processed = processor->Process(records, fileno(file));
+    std::rewind(file);
+    char buffer[4096];
+    for (auto count = std::fread(buffer, 1, sizeof(buffer), file); count != 0;
+         count = std::fread(buffer, 1, sizeof(buffer), file)) {
+      output.append(buffer, count);
+    }
+  } catch (...) {
+    std::fclose(file);
+    throw;
+  }
+  std::fclose(file);
+  return output;
+}
+
+// Enough records for several slices, with errors of every kind.
+static std::vector<std::string> ManyNumbers(size_t count) {
+  static const std::vector<std::string> kNumbers{
+      "1,2", "//;\n3;4", "", "1,-2,-3", "1,,2", "2147483648", "//[\n1", "5"};
+  std::vector<std::string> numbers;
+  for (size_t i = 0; i < count; ++i) {
+    numbers.push_back(i % 100 == 99 ? kNumbers[i / 100 % kNumbers.size()]
+                                    : std::to_string(i) + ",1");
+  }
+  return numbers;
+}
+
+SCENARIO("RecordProcessor writes a line per record in order") {
+  const auto numbers = ManyNumbers(10000);
+  std::string expected;
+  size_t expected_errors = 0;
+  for (const auto& record : numbers) {
+    expected += LineOf(record);
+    expected_errors += LineOf(record).substr(0, 5) == "error";
+  }
+
+  GIVEN("processor that reports errors") {
+    RecordProcessor processor(3, ErrorPolicy::kReport);
+
+    WHEN("process records of several batches") {
+      THEN("lines are sums or errors as Add reports them") {
+        for (size_t batch = 1; batch <= 2; ++batch) {
+          size_t processed = 0;
+          REQUIRE_EQ(Process(&processor, numbers, &processed), expected);
+          REQUIRE_EQ(processed, numbers.size());
+          REQUIRE_EQ(processor.Errors(), batch * expected_errors);
+        }
+      }
+    }
+  }
+
+  GIVEN("processor that fails fast") {
+    RecordProcessor processor(3, ErrorPolicy::kFailFast);
+
+    WHEN("process records with an error in a later slice") {
+      auto valid = numbers;
+      for (auto& record : valid) {
+        record = LineOf(record).substr(0, 5) == "error" ? "0" : record;
+      }
+      static const auto kFirstError = size_t{7777};
+      valid[kFirstError] = "1,-2";
+      valid[kFirstError + 1] = "1,,2";
+      size_t processed = 0;
+      const auto output = Process(&processor, valid, &processed);
+
+      THEN("only lines before the first error are written") {
+        REQUIRE_EQ(processed, kFirstError);
+        std::string lines;
+        for (size_t i = 0; i < kFirstError; ++i) {
+          lines += LineOf(valid[i]);
+        }
+        REQUIRE_EQ(output, lines);
+        REQUIRE_EQ(processor.Errors(), 1);
+        REQUIRE_EQ(processor.FailFastMessage(), "negatives not allowed: -2 ");
+      }
+    }
+
+    WHEN("process records without errors") {
+      size_t processed = 0;
+      const auto output = Process(&processor, {"1,2", "3"}, &processed);
+
+      THEN("all lines are written") {
+        REQUIRE_EQ(processed, 2);
+        REQUIRE_EQ(output, "3\n3\n");
+        REQUIRE_EQ(processor.Errors(), 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,144 @@
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include <record_source.h>
+
+// Length prefixed record.
+static std::string Framed(const std::string& record) {
+  const auto size = static_cast<uint32_t>(record.size());
+  std::string framed;
+  for (auto shift = 0u; shift < 32; shift += 8) {
+    framed += static_cast<char>(size >> shift & 0xff);
+  }
+  return framed + record;
+}
+
+// Records of all batches of source.
+static std::vector<std::string> ReadAll(RecordSource* source,
+                                        size_t batch_size) {
+  std::vector<std::string> all;
+  std::vector<std::string_view> records;
+  for (source->NextBatch(batch_size, &records); !records.empty();
+       source->NextBatch(batch_size, &records)) {
+    REQUIRE(records.size() <= batch_size);
+    all.insert(std::end(all), std::begin(records), std::end(records));
+  }
+  return all;
+}
+
+// Records of data read from a regular file, which is memory mapped.
+static std::vector<std::string> ReadFile(const std::string& data,
+                                         Framing framing,
+                                         size_t batch_size = 2) {
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  std::fwrite(data.data(), 1, data.size(), file);
+  std::fflush(file);
+  std::vector<std::string> records;
+  try {
+    RecordSource source(fileno(file), framing);
+    records = ReadAll(&source, batch_size);
+    REQUIRE_EQ(source.BytesRead(), data.size());
+  } catch (...) {
+    std::fclose(file);
+    throw;
+  }
+  std::fclose(file);
+  return records;
+}
+
+// Records of data read from a pipe, which is read in blocks.
+static std::vector<std::string> ReadPipe(const std::string& data,
+                                         Framing framing) {
+  int ends[2];
+  REQUIRE_EQ(pipe(ends), 0);
+  std::thread writer([&] {
+    for (size_t written = 0; written < data.size();) {
+      const auto count =
+          write(ends[1], data.data() + written, data.size() - written);
+      if (count <= 0) {
+        break;
+      }
+      written += static_cast<size_t>(count);
+    }
+    close(ends[1]);
+  });
+  std::vector<std::string> records;
+  try {
+    RecordSource source(ends[0], framing);
+    records = ReadAll(&source, 1000);
+  } catch (...) {
+    writer.join();
+    close(ends[0]);
+    throw;
+  }
+  writer.join();
+  close(ends[0]);
+  return records;
+}
+
+SCENARIO("RecordSource splits input into records") {
+  GIVEN("lines with empty ones and the last one without new line") {
+    static const auto kLines = "1,2\n\n//;\n3\n4";
+
+    WHEN("read them from a file and from a pipe") {
+      THEN("every line is a record") {
+        const std::vector<std::string> expected{"1,2", "", "//;", "3", "4"};
+        REQUIRE_EQ(ReadFile(kLines, Framing::kNewline), expected);
+        REQUIRE_EQ(ReadPipe(kLines, Framing::kNewline), expected);
+      }
+    }
+  }
+
+  GIVEN("length prefixed records with new lines and an empty one") {
+    const auto data = Framed("//;\n1;2") + Framed("") + Framed("1\n2,3");
+
+    WHEN("read them from a file and from a pipe") {
+      THEN("records are exactly what was framed") {
+        const std::vector<std::string> expected{"//;\n1;2", "", "1\n2,3"};
+        REQUIRE_EQ(ReadFile(data, Framing::kLengthPrefixed), expected);
+        REQUIRE_EQ(ReadFile(data, Framing::kLengthPrefixed, 1), expected);
+        REQUIRE_EQ(ReadPipe(data, Framing::kLengthPrefixed), expected);
+      }
+    }
+  }
+
+  GIVEN("length prefixed records with the last one cut short") {
+    const auto record = Framed("1,2");
+    const auto cut_in_length = record + record.substr(0, 2);
+    const auto cut_in_record = record + record.substr(0, 5);
+
+    WHEN("read them") {
+      THEN("runtime error is thrown") {
+        for (const auto& data : {cut_in_length, cut_in_record}) {
+          REQUIRE_THROWS_AS(ReadFile(data, Framing::kLengthPrefixed),
+                            const std::runtime_error&);
+          REQUIRE_THROWS_AS(ReadPipe(data, Framing::kLengthPrefixed),
+                            const std::runtime_error&);
+        }
+      }
+    }
+  }
+
+  GIVEN("records longer than a block of a pipe") {
+    const auto huge = std::string(9 << 20, '1');
+    const auto data = Framed("2") + Framed(huge) + Framed("3");
+
+    WHEN("read them from a pipe") {
+      THEN("block grows to fit them") {
+        const std::vector<std::string> expected{"2", huge, "3"};
+        REQUIRE(ReadPipe(data, Framing::kLengthPrefixed) == expected);
+        REQUIRE(ReadPipe("2\n" + huge + "\n3", Framing::kNewline) == expected);
+      }
+    }
+  }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <exception>
+#include <string>
+#include <typeinfo>
+
+// Result of calculate or type and message of exception it threw, so results
+// and errors of different calculators can be compared with one check.
+template <typename Calculate>
+std::string ResultOf(Calculate calculate) {
+  try {
+    return std::to_string(calculate());
+  } catch (const std::exception& e) {
+    return std::string(typeid(e).name()) + ": " + e.what();
+  }
+}
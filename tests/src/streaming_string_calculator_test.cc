@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <doctest.h>
+
+#include <result_of.h>
+#include <streaming_string_calculator.h>
+#include <string_calculator.h>
+
+// Results start with numbers to show them in failed checks.
+static std::string Add(const std::string& numbers) {
+  return numbers + " = " +
+         ResultOf([&] { return StringCalculator::Add(numbers); });
+}
+
+static std::string AddByChunks(const std::string& numbers,
+                               const std::vector<size_t>& chunk_sizes) {
+  StreamingStringCalculator calculator;
+  return numbers + " = " + ResultOf([&] {
+    size_t pos = 0;
+    for (const auto size : chunk_sizes) {
+      calculator.Feed(std::string_view(numbers).substr(pos, size));
+      pos = std::min(pos + size, numbers.size());
+    }
+    calculator.Feed(std::string_view(numbers).substr(pos));
+    return calculator.Finish();
+  });
+}
+
+static const std::vector<std::string> kNumbers{"",
+                                               "1",
+                                               "1,2",
+                                               "22,0,1,5,11",
+                                               "1\n2,3",
+                                               "//;\n1;2",
+                                               "//*\n1*2\n5",
+                                               "-5",
+                                               "1,-5,4,-3,6,-1",
+                                               "2,1001",
+                                               "//[***]\n1***2***3",
+                                               "//[*][x][z]\n1*2x3",
+                                               "//[***][xx][z]\n1***2xx3",
+                                               "//[x][xx]\n1xx2x3xxx4",
+                                               "//[***][xx]\n-1***2**3xx-4",
+                                               "1,2,",
+                                               "1,,2",
+                                               "12abc, 3,+4",
+                                               "1,2147483648",
+                                               "/",
+                                               "//",
+                                               "//1,2",
+                                               "//\n1",
+                                               "/1,2"};
+
+SCENARIO("StreamingStringCalculator gives same results as Add") {
+  GIVEN("numbers split in two chunks at every position") {
+    THEN("result is the same as for whole numbers") {
+      for (const auto& numbers : kNumbers) {
+        for (size_t split = 0; split <= numbers.size(); ++split) {
+          REQUIRE_EQ(AddByChunks(numbers, {split}), Add(numbers));
+        }
+      }
+    }
+  }
+
+  GIVEN("numbers fed byte by byte") {
+    THEN("result is the same as for whole numbers") {
+      for (const auto& numbers : kNumbers) {
+        REQUIRE_EQ(AddByChunks(numbers, std::vector<size_t>(numbers.size(), 1)),
+                   Add(numbers));
+      }
+    }
+  }
+
+  GIVEN("randomized numbers split in random chunks") {
+    std::mt19937 random(2017);
+    static const std::vector<std::string> kHeaders{
+        "", "", "//;\n", "//[***][xx][z]\n", "//[ab][bc][abc]\n"};
+    static const std::string kAlphabet = "0123456789-,\n*xzabc;";
+
+    THEN("result is the same as for whole numbers") {
+      for (auto i = 0; i < 5000; ++i) {
+        auto numbers = kHeaders[random() % kHeaders.size()];
+        const auto size = random() % 100;
+        for (size_t j = 0; j < size; ++j) {
+          numbers += random() % 2 ? kAlphabet[random() % kAlphabet.size()]
+                                  : kAlphabet[random() % 10];
+        }
+        std::vector<size_t> chunk_sizes(random() % 6);
+        for (auto& chunk_size : chunk_sizes) {
+          chunk_size = random() % 8;
+        }
+        REQUIRE_EQ(AddByChunks(numbers, chunk_sizes), Add(numbers));
+      }
+    }
+  }
+
+  GIVEN("calculator that finished with error") {
+    StreamingStringCalculator calculator;
+    calculator.Feed("//;\n1;-2");
+    REQUIRE_THROWS_AS(calculator.Finish(), const std::logic_error&);
+
+    WHEN("feed it with new numbers") {
+      calculator.Feed("3,4");
+
+      THEN("previous numbers are forgotten") {
+        REQUIRE_EQ(calculator.Finish(), 7);
+      }
+    }
+  }
+}
+
+// New empty file only this run uses, so concurrent runs do not clash.
+static std::filesystem::path TemporaryFile() {
+  auto path = (std::filesystem::temp_directory_path() /
+               "string_calculator_test.XXXXXX")
+                  .string();
+  const auto file = mkstemp(path.data());
+  REQUIRE(file != -1);
+  close(file);
+  return path;
+}
+
+SCENARIO("StreamingStringCalculator adds numbers from file") {
+  const auto path = TemporaryFile();
+
+  GIVEN("file with large amount of numbers") {
+    std::string numbers = "//[***][xx]\n";
+    for (auto i = 0; i < 200000; ++i) {
+      numbers += std::to_string(i % 1200) + (i % 2 ? "***" : "xx");
+    }
+    std::ofstream(path, std::ios::binary) << numbers;
+
+    THEN("sum is the same as for numbers in memory") {
+      REQUIRE_EQ(StreamingStringCalculator::AddFile(path.string()),
+                 StringCalculator::Add(numbers));
+    }
+  }
+
+  GIVEN("empty file") {
+    std::ofstream(path, std::ios::binary).flush();
+
+    THEN("sum is zero") {
+      REQUIRE_EQ(StreamingStringCalculator::AddFile(path.string()), 0);
+    }
+  }
+
+  GIVEN("file that does not exist") {
+    std::filesystem::remove(path);
+
+    THEN("system error is thrown") {
+      REQUIRE_THROWS_AS(StreamingStringCalculator::AddFile(path.string()),
+                        const std::system_error&);
+    }
+  }
+
+  std::filesystem::remove(path);
+}
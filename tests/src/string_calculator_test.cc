@@ -1,8 +1,14 @@
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <doctest.h>
 
+#include <result_of.h>
 #include <string_calculator.h>
+#include <work_stealing_pool.h>
 
 SCENARIO("StringCalculator add numbers in string") {
   GIVEN("empty string") {
@@ -162,4 +168,252 @@ SCENARIO("StringCalculator add numbers in string") {
       THEN("all delimiters are used as default") { REQUIRE_EQ(result, 6); }
     }
   }
+
+  GIVEN("string view on part of larger buffer") {
+    static const auto kBuffer = "1,2,3,4";
+    const std::string_view numbers(kBuffer, 3);
+
+    WHEN("call add with that view as argument") {
+      const auto result = StringCalculator::Add(numbers);
+
+      THEN("only numbers inside view are summed") { REQUIRE_EQ(result, 3); }
+    }
+  }
+
+  GIVEN("string with trailing delimiter") {
+    static const auto kTrailingDelimiter = "1,2,";
+
+    WHEN("call add with that string as argument") {
+      const auto result = StringCalculator::Add(kTrailingDelimiter);
+
+      THEN("trailing delimiter is ignored") { REQUIRE_EQ(result, 3); }
+    }
+  }
+
+  GIVEN("string with two delimiters in a row") {
+    static const auto kEmptyNumber = "1,,2";
+
+    WHEN("call add with that string as argument") {
+      THEN("invalid argument exception should be thrown") {
+        REQUIRE_THROWS_AS(StringCalculator::Add(kEmptyNumber),
+                          const std::invalid_argument&);
+      }
+    }
+  }
+
+  GIVEN("string with number that does not fit into int") {
+    static const auto kHugeNumber = "1,2147483648";
+
+    WHEN("call add with that string as argument") {
+      THEN("out of range exception should be thrown") {
+        REQUIRE_THROWS_AS(StringCalculator::Add(kHugeNumber),
+                          const std::out_of_range&);
+      }
+    }
+  }
+
+  GIVEN("strings with header without delimiters") {
+    static const auto kEmptyHeaders = {"//\n1", "//[\n1"};
+
+    WHEN("call add with them") {
+      THEN("out of range exception should be thrown") {
+        for (const auto numbers : kEmptyHeaders) {
+          REQUIRE_THROWS_AS(StringCalculator::Add(numbers),
+                            const std::out_of_range&);
+          std::string message;
+          try {
+            StringCalculator::Add(numbers);
+          } catch (const std::out_of_range& e) {
+            message = e.what();
+          }
+          REQUIRE_EQ(message, "empty delimiters header");
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("StringCalculator reports errors without exceptions") {
+  GIVEN("string with valid numbers") {
+    static const auto kNumbers = "//[***]\n1***2\n3";
+
+    WHEN("call try add with that string") {
+      const auto result = StringCalculator::TryAdd(kNumbers);
+
+      THEN("result has sum and no error") {
+        REQUIRE(result.Ok());
+        REQUIRE_EQ(result.sum, 6);
+        REQUIRE(result.negative_numbers.empty());
+        REQUIRE(result.Message().empty());
+      }
+    }
+  }
+
+  GIVEN("string with multiple negative numbers") {
+    static const auto kNegativeNumbers = "//[***]\n1***-5***4\n-3";
+
+    WHEN("call try add with that string") {
+      const auto result = StringCalculator::TryAdd(kNegativeNumbers);
+
+      THEN("negatives are reported with their positions in the string") {
+        REQUIRE(result.error == AddError::kNegativeNumbers);
+        REQUIRE_EQ(result.negative_numbers.size(), 2);
+        REQUIRE_EQ(result.negative_numbers[0].value, -5);
+        REQUIRE_EQ(result.negative_numbers[0].position, 12);
+        REQUIRE_EQ(result.negative_numbers[1].value, -3);
+        REQUIRE_EQ(result.negative_numbers[1].position, 19);
+        REQUIRE_EQ(result.Message(), "negatives not allowed: -5 -3 ");
+      }
+    }
+  }
+
+  GIVEN("strings with malformed numbers and header") {
+    WHEN("call try add with them") {
+      THEN("error is reported instead of thrown") {
+        REQUIRE(StringCalculator::TryAdd("-1,,2").error ==
+                AddError::kInvalidNumber);
+        REQUIRE(StringCalculator::TryAdd("-1,,2").negative_numbers.empty());
+        REQUIRE(StringCalculator::TryAdd("1,2147483648").error ==
+                AddError::kNumberOutOfRange);
+        REQUIRE(StringCalculator::TryAdd("//[\n1").error ==
+                AddError::kInvalidHeader);
+      }
+    }
+  }
+
+  GIVEN("strings that make add throw") {
+    static const std::vector<std::string> kNumbers{
+        "1,-5,4,-3,6,-1", "1,,2", "1,2147483648", "//\n1", "//[\n1", "x"};
+
+    WHEN("call add and try add with them") {
+      THEN("message of result is what add throws") {
+        for (const auto& numbers : kNumbers) {
+          std::string message;
+          try {
+            StringCalculator::Add(numbers);
+          } catch (const std::exception& e) {
+            message = e.what();
+          }
+          REQUIRE_FALSE(message.empty());
+          REQUIRE_EQ(StringCalculator::TryAdd(numbers).Message(), message);
+        }
+      }
+    }
+  }
+}
+
+static std::string RandomNumbers(const std::string& header,
+                                 const std::vector<std::string>& delimiters,
+                                 size_t size,
+                                 int negative_every) {
+  std::mt19937 random(2017);
+  auto numbers = header;
+  while (numbers.size() < size) {
+    auto number = static_cast<int>(random() % 1500);
+    if (random() % static_cast<unsigned>(negative_every) == 0) {
+      number = -number - 1;
+    }
+    numbers += std::to_string(number);
+    numbers += delimiters[random() % delimiters.size()];
+  }
+  return numbers;
+}
+
+SCENARIO("StringCalculator adds large numbers in parallel") {
+  static const auto kSize = (size_t{3} << 20) + 1024;  // Enough for 3 threads.
+  static const auto kThreads = {size_t{1}, size_t{2}, size_t{3}, size_t{8}};
+
+  GIVEN("large numbers with default delimiters") {
+    const auto numbers = RandomNumbers("", {",", "\n"}, kSize, 1 << 30);
+
+    THEN("parallel sum is the same as sequential one") {
+      const auto sum = StringCalculator::Add(numbers);
+      for (const auto threads : kThreads) {
+        WorkStealingPool pool(threads);
+        REQUIRE_EQ(StringCalculator::ParallelAdd(numbers, &pool), sum);
+      }
+    }
+  }
+
+  GIVEN("large numbers with overlapping multichar delimiters") {
+    const auto numbers = RandomNumbers("//[ab][bc][abc][***]\n",
+                                       {"ab", "bc", "abc", "***", "\n"},
+                                       kSize, 1 << 30);
+
+    THEN("parallel sum is the same as sequential one") {
+      const auto sum = StringCalculator::Add(numbers);
+      for (const auto threads : kThreads) {
+        WorkStealingPool pool(threads);
+        REQUIRE_EQ(StringCalculator::ParallelAdd(numbers, &pool), sum);
+      }
+    }
+  }
+
+  GIVEN("large numbers where delimiters overlap in every line") {
+    std::string numbers = "//[12][23]\n";
+    while (numbers.size() < kSize) {
+      numbers += "4123\n";  // "12" is matched first, so it is 4 + 3.
+    }
+
+    THEN("parts are split only where sequential add ends a delimiter") {
+      const auto sum = StringCalculator::Add(numbers);
+      REQUIRE_EQ(sum, 7 * static_cast<int>((numbers.size() - 11) / 5));
+      for (const auto threads : kThreads) {
+        WorkStealingPool pool(threads);
+        REQUIRE_EQ(StringCalculator::ParallelAdd(numbers, &pool), sum);
+      }
+    }
+  }
+
+  GIVEN("large numbers with negatives in every part") {
+    const auto numbers = RandomNumbers("//[***]\n", {"***"}, kSize, 5000);
+
+    THEN("message lists negatives of all parts in original order") {
+      const auto result =
+          ResultOf([&] { return StringCalculator::Add(numbers); });
+      for (const auto threads : kThreads) {
+        WorkStealingPool pool(threads);
+        REQUIRE_EQ(ResultOf([&] {
+                     return StringCalculator::ParallelAdd(numbers, &pool);
+                   }),
+                   result);
+      }
+    }
+  }
+
+  GIVEN("large numbers with negative at the beginning") {
+    // Ends with a single delimiter, one more makes the last number malformed.
+    const auto numbers = "-1," + RandomNumbers("", {","}, kSize, 1 << 30);
+    WorkStealingPool pool(3);
+
+    THEN("negative in the first part is reported") {
+      std::string message;
+      try {
+        StringCalculator::ParallelAdd(numbers, &pool);
+      } catch (const std::logic_error& e) {
+        message = e.what();
+      }
+      REQUIRE_EQ(message, "negatives not allowed: -1 ");
+    }
+
+    THEN("malformed number in the last part is reported instead") {
+      std::string message;
+      try {
+        StringCalculator::ParallelAdd(numbers + ",", &pool);
+      } catch (const std::invalid_argument& e) {
+        message = e.what();
+      }
+      REQUIRE_EQ(message, "stoi");
+    }
+  }
+
+  GIVEN("small numbers") {
+    WorkStealingPool pool(8);
+
+    THEN("they are added as by sequential add") {
+      REQUIRE_EQ(StringCalculator::ParallelAdd("//[***]\n1***2***3", &pool),
+                 6);
+      REQUIRE_EQ(StringCalculator::ParallelAdd("", &pool), 0);
+    }
+  }
 }
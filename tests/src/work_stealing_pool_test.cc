@@ -0,0 +1,37 @@
+#include <atomic>
+#include <vector>
+
+#include <doctest.h>
+
+#include <work_stealing_pool.h>
+
+SCENARIO("WorkStealingPool runs every task once") {
+  GIVEN("pool with several threads") {
+    WorkStealingPool pool(4);
+    REQUIRE_EQ(pool.Threads(), 4);
+
+    WHEN("run batches with more and less tasks than threads") {
+      THEN("each task of every batch is run exactly once") {
+        for (const auto tasks : {0, 1, 3, 4, 5, 1000}) {
+          std::vector<std::atomic<int>> runs(static_cast<size_t>(tasks));
+          pool.Run(runs.size(), [&](size_t task) noexcept { ++runs[task]; });
+          for (const auto& run : runs) {
+            REQUIRE_EQ(run.load(), 1);
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN("pool with single thread") {
+    WorkStealingPool pool(1);
+
+    THEN("tasks are run on calling thread") {
+      int sum = 0;
+      pool.Run(10, [&](size_t task) noexcept {
+        sum += static_cast<int>(task);
+      });
+      REQUIRE_EQ(sum, 45);
+    }
+  }
+}